@@ -0,0 +1,200 @@
+#include "availabilitykernel.h"
+
+#include <climits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define AVAILABILITY_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+int AvailabilityKernel::findFreeTablesScalar(const std::int32_t *seats,
+                                             const std::uint64_t *dayWords,
+                                             int first,
+                                             int tableCount,
+                                             std::uint64_t slotMask,
+                                             int minSeats,
+                                             int maxSeats,
+                                             std::vector<TableId> &out)
+{
+    int found = 0;
+    for (int i = first; i < tableCount; ++i) {
+        if (seats[i] < minSeats || seats[i] > maxSeats)
+            continue;
+        if (dayWords && (dayWords[i] & slotMask))
+            continue;
+        out.push_back(i);
+        ++found;
+    }
+    return found;
+}
+
+#ifdef AVAILABILITY_KERNEL_X86
+
+// Pushes the ids for each set bit of `bits`, lowest first
+static int emitMatches(unsigned bits, int base, std::vector<TableId> &out)
+{
+    int found = 0;
+    while (bits) {
+        out.push_back(base + __builtin_ctz(bits));
+        bits &= bits - 1;
+        ++found;
+    }
+    return found;
+}
+
+__attribute__((target("avx2")))
+static int findFreeTablesAvx2(const std::int32_t *seats,
+                              const std::uint64_t *dayWords,
+                              int tableCount,
+                              std::uint64_t slotMask,
+                              int minSeats,
+                              int maxSeats,
+                              std::vector<TableId> &out)
+{
+    // Seat bounds as exclusive limits for the signed 32-bit compares
+    const __m256i below = _mm256_set1_epi32(minSeats - 1);
+    const __m256i above = _mm256_set1_epi32(maxSeats + 1);
+    const __m256i mask = _mm256_set1_epi64x(static_cast<long long>(slotMask));
+    const __m256i zero = _mm256_setzero_si256();
+
+    int found = 0;
+    int i = 0;
+    for (; i + 8 <= tableCount; i += 8) {
+        __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(seats + i));
+        __m256i seatOk = _mm256_and_si256(_mm256_cmpgt_epi32(s, below), _mm256_cmpgt_epi32(above, s));
+        unsigned bits = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(seatOk)));
+
+        if (dayWords && bits) {
+            __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dayWords + i));
+            __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dayWords + i + 4));
+            __m256i freeLo = _mm256_cmpeq_epi64(_mm256_and_si256(lo, mask), zero);
+            __m256i freeHi = _mm256_cmpeq_epi64(_mm256_and_si256(hi, mask), zero);
+            unsigned freeBits = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(freeLo)))
+                                | static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(freeHi))) << 4;
+            bits &= freeBits;
+        }
+
+        found += emitMatches(bits, i, out);
+    }
+
+    return found + AvailabilityKernel::findFreeTablesScalar(seats, dayWords, i, tableCount,
+                                                            slotMask, minSeats, maxSeats, out);
+}
+
+__attribute__((target("sse4.1")))
+static int findFreeTablesSse41(const std::int32_t *seats,
+                               const std::uint64_t *dayWords,
+                               int tableCount,
+                               std::uint64_t slotMask,
+                               int minSeats,
+                               int maxSeats,
+                               std::vector<TableId> &out)
+{
+    const __m128i below = _mm_set1_epi32(minSeats - 1);
+    const __m128i above = _mm_set1_epi32(maxSeats + 1);
+    const __m128i mask = _mm_set1_epi64x(static_cast<long long>(slotMask));
+    const __m128i zero = _mm_setzero_si128();
+
+    int found = 0;
+    int i = 0;
+    for (; i + 4 <= tableCount; i += 4) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(seats + i));
+        __m128i seatOk = _mm_and_si128(_mm_cmpgt_epi32(s, below), _mm_cmplt_epi32(s, above));
+        unsigned bits = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(seatOk)));
+
+        if (dayWords && bits) {
+            __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dayWords + i));
+            __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dayWords + i + 2));
+            __m128i freeLo = _mm_cmpeq_epi64(_mm_and_si128(lo, mask), zero);
+            __m128i freeHi = _mm_cmpeq_epi64(_mm_and_si128(hi, mask), zero);
+            unsigned freeBits = static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(freeLo)))
+                                | static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(freeHi))) << 2;
+            bits &= freeBits;
+        }
+
+        found += emitMatches(bits, i, out);
+    }
+
+    return found + AvailabilityKernel::findFreeTablesScalar(seats, dayWords, i, tableCount,
+                                                            slotMask, minSeats, maxSeats, out);
+}
+
+#endif // AVAILABILITY_KERNEL_X86
+
+AvailabilityKernel::Path AvailabilityKernel::activePath()
+{
+#ifdef AVAILABILITY_KERNEL_X86
+    static const Path path = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return Path::AVX2;
+        if (__builtin_cpu_supports("sse4.1"))
+            return Path::SSE41;
+        return Path::Scalar;
+    }();
+    return path;
+#else
+    return Path::Scalar;
+#endif
+}
+
+const char *AvailabilityKernel::pathName(Path path)
+{
+    switch (path) {
+    case Path::AVX2:
+        return "AVX2";
+    case Path::SSE41:
+        return "SSE4.1";
+    case Path::Scalar:
+        break;
+    }
+    return "scalar";
+}
+
+int AvailabilityKernel::findFreeTables(const std::int32_t *seats,
+                                       const std::uint64_t *dayWords,
+                                       int tableCount,
+                                       std::uint64_t slotMask,
+                                       int minSeats,
+                                       int maxSeats,
+                                       std::vector<TableId> &out)
+{
+    return findFreeTables(activePath(), seats, dayWords, tableCount, slotMask, minSeats, maxSeats, out);
+}
+
+int AvailabilityKernel::findFreeTables(Path path,
+                                       const std::int32_t *seats,
+                                       const std::uint64_t *dayWords,
+                                       int tableCount,
+                                       std::uint64_t slotMask,
+                                       int minSeats,
+                                       int maxSeats,
+                                       std::vector<TableId> &out)
+{
+    // Keep the +/-1 used for exclusive bounds from overflowing
+    if (minSeats < 0)
+        minSeats = 0;
+    if (maxSeats > INT_MAX - 1)
+        maxSeats = INT_MAX - 1;
+    if (tableCount <= 0 || minSeats > maxSeats)
+        return 0;
+
+#ifdef AVAILABILITY_KERNEL_X86
+    if (path == Path::AVX2 && activePath() != Path::AVX2)
+        path = Path::SSE41;
+    if (path == Path::SSE41 && activePath() == Path::Scalar)
+        path = Path::Scalar;
+
+    switch (path) {
+    case Path::AVX2:
+        return findFreeTablesAvx2(seats, dayWords, tableCount, slotMask, minSeats, maxSeats, out);
+    case Path::SSE41:
+        return findFreeTablesSse41(seats, dayWords, tableCount, slotMask, minSeats, maxSeats, out);
+    case Path::Scalar:
+        break;
+    }
+#else
+    (void)path;
+#endif
+    return findFreeTablesScalar(seats, dayWords, 0, tableCount, slotMask, minSeats, maxSeats, out);
+}
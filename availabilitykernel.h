@@ -0,0 +1,56 @@
+#ifndef AVAILABILITYKERNEL_H
+#define AVAILABILITYKERNEL_H
+
+#include <cstdint>
+#include <vector>
+
+#include "reservationtypes.h"
+
+// Vectorised "free tables with minSeats <= seats <= maxSeats" search over the
+// struct-of-arrays table catalog. `dayWords` holds one SlotGrid word per
+// table (nullptr when nothing is booked that day); a table is free when none
+// of the bits in `slotMask` are set in its word.
+//
+// The AVX2 and SSE4.1 paths are compiled with per-function target attributes
+// and chosen at runtime, so the same binary still runs on older CPUs.
+class AvailabilityKernel
+{
+public:
+    enum class Path { Scalar, SSE41, AVX2 };
+
+    static Path activePath();
+    static const char *pathName(Path path);
+
+    // Appends matching table ids to `out` in ascending order and returns how
+    // many were added.
+    static int findFreeTables(const std::int32_t *seats,
+                              const std::uint64_t *dayWords,
+                              int tableCount,
+                              std::uint64_t slotMask,
+                              int minSeats,
+                              int maxSeats,
+                              std::vector<TableId> &out);
+
+    // The same search on a given path, so each one can be checked against
+    // the scalar version. A path the CPU lacks falls back to the next one.
+    static int findFreeTables(Path path,
+                              const std::int32_t *seats,
+                              const std::uint64_t *dayWords,
+                              int tableCount,
+                              std::uint64_t slotMask,
+                              int minSeats,
+                              int maxSeats,
+                              std::vector<TableId> &out);
+
+    // Portable reference version; also finishes the tail of the SIMD passes
+    static int findFreeTablesScalar(const std::int32_t *seats,
+                                    const std::uint64_t *dayWords,
+                                    int first,
+                                    int tableCount,
+                                    std::uint64_t slotMask,
+                                    int minSeats,
+                                    int maxSeats,
+                                    std::vector<TableId> &out);
+};
+
+#endif // AVAILABILITYKERNEL_H
@@ -0,0 +1,99 @@
+#include "floorplanrenderer.h"
+
+#include <QStyle>
+
+void FloorPlanRenderer::stage(TableId id, QPushButton *button, State state)
+{
+    if (id < 0 || !button)
+        return;
+
+    if (id >= rendered.size()) {
+        rendered.resize(id + 1, -1);
+        pendingAt.resize(id + 1, -1);
+    }
+
+    // Restaging before commit replaces the queued state; commit skips it if
+    // that is back to what is on screen
+    int &queued = pendingAt[id];
+    if (queued >= 0) {
+        pending[queued].button = button;
+        pending[queued].state = state;
+        return;
+    }
+    if (rendered[id] == state)
+        return;
+
+    queued = pending.size();
+    pending.append({id, button, state});
+}
+
+int FloorPlanRenderer::commit()
+{
+    if (pending.isEmpty())
+        return 0;
+
+    // A handful of changes (the click-to-select path) is cheaper to apply
+    // directly; larger batches share one updates-disabled window so the page
+    // repaints once instead of once per button.
+    QWidget *batchRoot = nullptr;
+    if (pending.size() >= kBatchThreshold && pending.first().button) {
+        batchRoot = pending.first().button->parentWidget();
+        if (batchRoot && !batchRoot->updatesEnabled())
+            batchRoot = nullptr;
+        if (batchRoot)
+            batchRoot->setUpdatesEnabled(false);
+    }
+
+    int touched = 0;
+    for (const Change &change : pending) {
+        pendingAt[change.id] = -1;
+        if (!change.button || rendered[change.id] == change.state)
+            continue;
+
+        int previous = rendered[change.id];
+        apply(change.button, static_cast<State>(previous), change.state, previous >= 0);
+        rendered[change.id] = change.state;
+        ++touched;
+    }
+    pending.clear();
+
+    if (batchRoot)
+        batchRoot->setUpdatesEnabled(true);
+
+    return touched;
+}
+
+void FloorPlanRenderer::invalidate()
+{
+    rendered.fill(-1);
+    pendingAt.fill(-1);
+    pending.clear();
+}
+
+const char *FloorPlanRenderer::lookFor(State state)
+{
+    if (state & Reserved)
+        return "reserved";
+    if (state & Selected)
+        return "selected";
+    return "available";
+}
+
+void FloorPlanRenderer::apply(QPushButton *button, State previous, State state, bool known)
+{
+    bool visible = !(state & FilteredOut);
+    if (!known || visible != !(previous & FilteredOut)) {
+        button->setVisible(visible);
+    }
+
+    // Look changes need a re-polish so the shared stylesheet picks up the
+    // new tableState / isVIP property values
+    const State lookMask = Reserved | Selected | VIP;
+    if (known && (previous & lookMask) == (state & lookMask))
+        return;
+
+    button->setProperty("tableState", lookFor(state));
+    button->setProperty("isVIP", bool(state & VIP));
+    button->style()->unpolish(button);
+    button->style()->polish(button);
+}
@@ -0,0 +1,52 @@
+#ifndef FLOORPLANRENDERER_H
+#define FLOORPLANRENDERER_H
+
+#include <QPointer>
+#include <QPushButton>
+#include <QVector>
+
+#include "reservationtypes.h"
+
+// Remembers what each floor plan button currently shows and only touches
+// buttons whose state actually changed. Callers stage the state they want
+// for any number of tables and then commit; large commits are applied
+// inside a single setUpdatesEnabled(false/true) window.
+class FloorPlanRenderer
+{
+public:
+    enum StateFlag : quint8 {
+        Reserved = 0x1,
+        Selected = 0x2,
+        FilteredOut = 0x4,
+        VIP = 0x8,
+    };
+    using State = quint8;
+
+    // Stage `state` for a table; a no-op when that is what is on screen
+    void stage(TableId id, QPushButton *button, State state);
+    // Applies staged changes and returns how many buttons were touched
+    int commit();
+
+    // Forget what was rendered so the next commit repaints everything
+    void invalidate();
+
+    static const char *lookFor(State state);
+
+private:
+    struct Change
+    {
+        TableId id;
+        QPointer<QPushButton> button;
+        State state;
+    };
+
+    static void apply(QPushButton *button, State previous, State state, bool known);
+
+    static constexpr int kBatchThreshold = 4;
+
+    QVector<int> rendered;  // Last applied State per TableId, -1 if unknown
+    QVector<Change> pending;
+    QVector<int> pendingAt;  // Index into pending per TableId, -1 if none
+};
+
+#endif // FLOORPLANRENDERER_H
@@ -0,0 +1,217 @@
+#include "floorplanview.h"
+
+#include <QGraphicsScene>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QWheelEvent>
+
+#include <algorithm>
+#include <cmath>
+
+// Zoom levels (device pixels per scene unit) at which more detail is drawn
+static const qreal kLabelDetail = 0.5;
+static const qreal kSeatDetail = 1.0;
+static const qreal kSeatDotSize = 10.0;
+
+FloorPlanTableItem::FloorPlanTableItem(TableId id, const QString &label, int seats)
+    : id(id)
+    , label(label)
+    , seats(seats)
+{
+    setCacheMode(QGraphicsItem::DeviceCoordinateCache);
+    setFlag(QGraphicsItem::ItemIsSelectable, false);
+    setAcceptHoverEvents(false);
+}
+
+QSizeF FloorPlanTableItem::tableSize(int seats)
+{
+    // Two seats per side along the long edge, tables grow with the party size
+    int perSide = std::max(1, (seats + 1) / 2);
+    return QSizeF(40.0 + perSide * 20.0, 60.0);
+}
+
+QRectF FloorPlanTableItem::boundingRect() const
+{
+    QSizeF size = tableSize(seats);
+    return QRectF(-kSeatDotSize, -kSeatDotSize,
+                  size.width() + 2 * kSeatDotSize, size.height() + 2 * kSeatDotSize);
+}
+
+void FloorPlanTableItem::setState(FloorPlanRenderer::State newState)
+{
+    // Only a real change invalidates the cached pixmap
+    if (state == newState)
+        return;
+
+    bool wasVisible = state < 0 || !(state & FloorPlanRenderer::FilteredOut);
+    bool visible = !(newState & FloorPlanRenderer::FilteredOut);
+    state = newState;
+
+    if (visible != wasVisible)
+        setVisible(visible);
+    update();
+}
+
+void FloorPlanTableItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(widget);
+
+    FloorPlanRenderer::State flags = state < 0 ? 0 : static_cast<FloorPlanRenderer::State>(state);
+    QColor fill("#FFFFFF");
+    QColor border("#E0E0E0");
+    QColor text("#2C3E50");
+    if (flags & FloorPlanRenderer::Reserved) {
+        fill = QColor("#F44336");
+        border = QColor("#D32F2F");
+        text = Qt::white;
+    } else if (flags & FloorPlanRenderer::Selected) {
+        fill = QColor("#4CAF50");
+        border = QColor("#388E3C");
+        text = Qt::white;
+    } else if (flags & FloorPlanRenderer::VIP) {
+        fill = QColor("#FFF8E1");
+        border = QColor("#FFD700");
+    }
+
+    const QRectF table(QPointF(0, 0), tableSize(seats));
+    const qreal lod = option->levelOfDetailFromTransform(painter->worldTransform());
+
+    // Zoomed far out: a flat block is all that is visible anyway
+    if (lod < kLabelDetail) {
+        painter->fillRect(table, fill);
+        return;
+    }
+
+    painter->setPen(QPen(border, 1.5));
+    painter->setBrush(fill);
+    painter->drawRoundedRect(table, 12, 12);
+
+    painter->setPen(text);
+    painter->drawText(table, Qt::AlignCenter, label);
+
+    if (lod < kSeatDetail)
+        return;
+
+    // Seat dots along the top and bottom edges
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(QColor(193, 193, 193));
+    int perSide = std::max(1, (seats + 1) / 2);
+    qreal spacing = table.width() / perSide;
+    for (int seat = 0; seat < seats; ++seat) {
+        int column = seat / 2;
+        qreal x = spacing * (column + 0.5) - kSeatDotSize / 2;
+        qreal y = (seat % 2 == 0) ? -kSeatDotSize : table.height();
+        painter->drawEllipse(QRectF(x, y, kSeatDotSize, kSeatDotSize));
+    }
+}
+
+FloorPlanView::FloorPlanView(QWidget *parent)
+    : QGraphicsView(parent)
+{
+    setRenderHint(QPainter::Antialiasing);
+    setViewportUpdateMode(QGraphicsView::SmartViewportUpdate);
+    setOptimizationFlags(QGraphicsView::DontSavePainterState | QGraphicsView::DontAdjustForAntialiasing);
+    setCacheMode(QGraphicsView::CacheBackground);
+    setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
+    setDragMode(QGraphicsView::ScrollHandDrag);
+    setBackgroundBrush(QColor("#F8F9FA"));
+    setStyleSheet("QGraphicsView { border: none; }");
+}
+
+QGraphicsScene *FloorPlanView::sceneForFloor(int floor)
+{
+    while (floors.size() <= floor) {
+        QGraphicsScene *scene = new QGraphicsScene(this);
+        scene->setItemIndexMethod(QGraphicsScene::BspTreeIndex);
+        floors.append(scene);
+    }
+    return floors[floor];
+}
+
+void FloorPlanView::clearTables()
+{
+    setScene(nullptr);
+    qDeleteAll(floors);
+    floors.clear();
+    tableItems.clear();
+    floor = 0;
+}
+
+void FloorPlanView::addTable(TableId id, int floor, const QPointF &position, const QString &label, int seats)
+{
+    if (id < 0 || floor < 0)
+        return;
+
+    if (id >= tableItems.size()) {
+        tableItems.resize(id + 1, nullptr);
+    }
+    if (tableItems[id]) {
+        delete tableItems[id];
+    }
+
+    FloorPlanTableItem *item = new FloorPlanTableItem(id, label, seats);
+    item->setPos(position);
+    sceneForFloor(floor)->addItem(item);
+    tableItems[id] = item;
+
+    if (!scene()) {
+        setFloor(this->floor);
+    }
+}
+
+void FloorPlanView::setTableState(TableId id, FloorPlanRenderer::State state)
+{
+    if (id >= 0 && id < tableItems.size() && tableItems[id]) {
+        tableItems[id]->setState(state);
+    }
+}
+
+void FloorPlanView::setFloor(int floor)
+{
+    if (floor < 0 || floor >= floors.size())
+        return;
+
+    this->floor = floor;
+    setScene(floors[floor]);
+}
+
+void FloorPlanView::zoomToFit()
+{
+    if (scene()) {
+        fitInView(scene()->itemsBoundingRect(), Qt::KeepAspectRatio);
+    }
+}
+
+void FloorPlanView::wheelEvent(QWheelEvent *event)
+{
+    // Zoom around the cursor, clamped so the plan never vanishes or explodes
+    qreal factor = std::pow(1.0015, event->angleDelta().y());
+    qreal current = transform().m11();
+    qreal target = qBound(0.05, current * factor, 8.0);
+    scale(target / current, target / current);
+    event->accept();
+}
+
+void FloorPlanView::mousePressEvent(QMouseEvent *event)
+{
+    pressPosition = event->pos();
+    QGraphicsView::mousePressEvent(event);
+}
+
+void FloorPlanView::mouseReleaseEvent(QMouseEvent *event)
+{
+    QGraphicsView::mouseReleaseEvent(event);
+
+    // A drag pans the plan; only a click without movement selects a table
+    if (event->button() != Qt::LeftButton
+        || (event->pos() - pressPosition).manhattanLength() > 4)
+        return;
+
+    for (QGraphicsItem *item : items(event->pos())) {
+        if (auto *table = dynamic_cast<FloorPlanTableItem *>(item)) {
+            emit tableClicked(table->tableId());
+            return;
+        }
+    }
+}
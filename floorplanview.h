@@ -0,0 +1,72 @@
+#ifndef FLOORPLANVIEW_H
+#define FLOORPLANVIEW_H
+
+#include <QGraphicsItem>
+#include <QGraphicsView>
+#include <QVector>
+
+#include "floorplanrenderer.h"
+#include "reservationtypes.h"
+
+// One table on a FloorPlanView. Painting picks a level of detail from the
+// current zoom: a flat block when zoomed far out, then the outline and
+// label, and finally the seat dots. Items cache their rendering in device
+// coordinates, so panning just blits pixmaps.
+class FloorPlanTableItem : public QGraphicsItem
+{
+public:
+    FloorPlanTableItem(TableId id, const QString &label, int seats);
+
+    TableId tableId() const { return id; }
+    void setState(FloorPlanRenderer::State state);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+    static QSizeF tableSize(int seats);
+
+private:
+    TableId id;
+    QString label;
+    int seats;
+    int state = -1;
+};
+
+// Scalable floor plan for venues with more tables than the fixed Table1..14
+// buttons in home.ui can hold. Each floor has its own QGraphicsScene with a
+// BSP item index, so hit-testing and exposure stay logarithmic as the
+// number of tables grows.
+class FloorPlanView : public QGraphicsView
+{
+    Q_OBJECT
+
+public:
+    explicit FloorPlanView(QWidget *parent = nullptr);
+
+    void clearTables();
+    void addTable(TableId id, int floor, const QPointF &position, const QString &label, int seats);
+    void setTableState(TableId id, FloorPlanRenderer::State state);
+
+    int floorCount() const { return floors.size(); }
+    int currentFloor() const { return floor; }
+    void setFloor(int floor);
+    void zoomToFit();
+
+signals:
+    void tableClicked(TableId id);
+
+protected:
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+
+private:
+    QGraphicsScene *sceneForFloor(int floor);
+
+    QVector<QGraphicsScene *> floors;
+    QVector<FloorPlanTableItem *> tableItems;  // Indexed by TableId, nullptr for gaps
+    int floor = 0;
+    QPoint pressPosition;
+};
+
+#endif // FLOORPLANVIEW_H
@@ -1,7 +1,13 @@
 #include "home.h"
 #include "ui_home.h"
+#include "statementcache.h"
 
+#include <algorithm>
+#include <climits>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <set>
 
 #include <QDebug>
 #include <QFile>
@@ -15,25 +21,136 @@
 #include <QSqlError>
 #include <QDebug>
 
+// Every look a floor plan button can have. Installed once on the dialog and
+// selected per button through the "tableState" and "isVIP" dynamic
+// properties, so changing a table's state never re-parses CSS.
+static const char *const kTableButtonStyle =
+    "QPushButton[tableState=\"available\"] {"
+    "    background: qlineargradient(spread:pad, x1:0, y1:0, x2:0, y2:1,"
+    "                               stop:0 #FFFFFF, stop:1 #F5F5F5);"
+    "    color: #2C3E50;"
+    "    border-radius: 12px;"
+    "    border: 1.5px solid #E0E0E0;"
+    "    font-size: 15px;"
+    "    font-weight: 500;"
+    "    padding: 12px 20px;"
+    "}"
+    "QPushButton[tableState=\"available\"][isVIP=\"true\"] {"
+    "    background: qlineargradient(spread:pad, x1:0, y1:0, x2:0, y2:1,"
+    "                               stop:0 #FFF8E1, stop:1 #FFF8DC);"
+    "    border: 1.5px solid #FFD700;"
+    "}"
+    "QPushButton[tableState=\"available\"]:hover {"
+    "    background: qlineargradient(spread:pad, x1:0, y1:0, x2:0, y2:1,"
+    "                               stop:0 #4CAF50, stop:1 #45A049);"
+    "    color: white;"
+    "    border-color: #388E3C;"
+    "}"
+    "QPushButton[tableState=\"available\"]:pressed {"
+    "    background: qlineargradient(spread:pad, x1:0, y1:0, x2:0, y2:1,"
+    "                               stop:0 #388E3C, stop:1 #2E7D32);"
+    "    color: white;"
+    "    border-color: #2E7D32;"
+    "}"
+    "QPushButton[tableState=\"selected\"] {"
+    "    background: qlineargradient(spread:pad, x1:0, y1:0, x2:0, y2:1,"
+    "                               stop:0 #4CAF50, stop:1 #45A049);"
+    "    color: white;"
+    "    border-radius: 12px;"
+    "    border: 1.5px solid #388E3C;"
+    "    font-size: 15px;"
+    "    font-weight: 500;"
+    "    padding: 12px 20px;"
+    "}"
+    "QPushButton[tableState=\"selected\"]:hover {"
+    "    background: qlineargradient(spread:pad, x1:0, y1:0, x2:0, y2:1,"
+    "                               stop:0 #66BB6A, stop:1 #4CAF50);"
+    "}"
+    "QPushButton[tableState=\"selected\"]:pressed {"
+    "    background: qlineargradient(spread:pad, x1:0, y1:0, x2:0, y2:1,"
+    "                               stop:0 #388E3C, stop:1 #2E7D32);"
+    "}"
+    "QPushButton[tableState=\"reserved\"] {"
+    "    background: qlineargradient(spread:pad, x1:0, y1:0, x2:0, y2:1,"
+    "                               stop:0 #FF5252, stop:1 #F44336);"
+    "    color: white;"
+    "    border-radius: 12px;"
+    "    border: 1.5px solid #D32F2F;"
+    "    font-size: 15px;"
+    "    font-weight: 500;"
+    "    padding: 12px 20px;"
+    "}"
+    "QPushButton[tableState=\"reserved\"]:hover {"
+    "    background: qlineargradient(spread:pad, x1:0, y1:0, x2:0, y2:1,"
+    "                               stop:0 #FF6B6B, stop:1 #FF5252);"
+    "}"
+    "QPushButton[tableState=\"reserved\"]:pressed {"
+    "    background: qlineargradient(spread:pad, x1:0, y1:0, x2:0, y2:1,"
+    "                               stop:0 #D32F2F, stop:1 #C62828);"
+    "}"
+    "QPushButton[tableState=\"available\"], QPushButton[tableState=\"selected\"],"
+    "QPushButton[tableState=\"reserved\"] {"
+    "    text-align: center;"
+    "    min-height: 80px;"
+    "}"
+    "QPushButton[tableState=\"available\"] QLabel, QPushButton[tableState=\"selected\"] QLabel,"
+    "QPushButton[tableState=\"reserved\"] QLabel {"
+    "    font-size: 12px;"
+    "    color: #666;"
+    "    margin-top: 4px;"
+    "}";
+
+static EpochSeconds toEpoch(const QDateTime &time)
+{
+    return time.toSecsSinceEpoch();
+}
+
+static QDateTime fromEpoch(EpochSeconds seconds)
+{
+    return QDateTime::fromSecsSinceEpoch(seconds);
+}
+
+// Rows per LIMIT/OFFSET page of the dashboard reservation list
+static const int kReservationPageSize = 64;
+// Quiet period after the last filter change before a search starts
+static const int kSearchDebounceMs = 250;
+
 Home::Home(QWidget *parent, const QString &userMode, int userId, const QString &username)
     : QDialog(parent), currentUser(username), userMode(userMode), userId(userId) // Store username
     , ui(new Ui::Home)
     , m_userMode(userMode)
-    , selectedTable(nullptr)
+    , selectedTable(-1)
     , m_sortAscending(true)
     , totalTables(14)  // Initialize with 14 tables since that's what we use
     , rightPanel(nullptr)
+    , reservationList(nullptr)
+    , reservationModel(nullptr)
+    , journal(new ReservationJournal("reservations.journal", this))
+    , writeQueue(new ReservationWriteQueue(this))
 {
     // Initialize table status
     for (int i = 1; i <= totalTables; i++) {
         tableStatus[i] = false;
     }
 
+    // Day/slot bitmaps are laid out in local time, with each date's own offset
+    engine.setUtcOffset([](EpochSeconds time) { return fromEpoch(time).offsetFromUtc(); });
+
+    // Fold the journal into a fresh snapshot once it gets long
+    connect(journal, &ReservationJournal::compactionDue, this, &Home::saveReservations);
+
     ui->setupUi(this);
     setupUI();
     setupTables();
-    setupConnections();
-    loadReservations();
+    setupConnections();  // setupTables has already loaded the reservations
+
+    // Reservation searches run on their own thread and SQLite connection
+    searchThread = new QThread(this);
+    searchWorker = new ReservationSearchWorker(kReservationPageSize);
+    searchWorker->moveToThread(searchThread);
+    connect(searchThread, &QThread::finished, searchWorker, &QObject::deleteLater);
+    connect(searchWorker, &ReservationSearchWorker::pageReady, this, &Home::onReservationPage);
+    searchThread->start();
 
     // Set up the pages
     setupReservationsPage();
@@ -62,10 +179,11 @@ void Home::setupUI()
     // Set window title and background
     setWindowTitle("Restaurant Table Reservation System");
     this->setStyleSheet(
-        "QDialog {"
-        "    background-color: #F8F9FA;"
-        "    font-family: -apple-system, BlinkMacSystemFont, 'Segoe UI', Roboto, Oxygen, Ubuntu, Cantarell, sans-serif;"
-        "}");
+        QString("QDialog {"
+                "    background-color: #F8F9FA;"
+                "    font-family: -apple-system, BlinkMacSystemFont, 'Segoe UI', Roboto, Oxygen, Ubuntu, Cantarell, sans-serif;"
+                "}")
+        + kTableButtonStyle);
 
     ui->sidebar->setStyleSheet(
         "QWidget {"
@@ -282,9 +400,22 @@ void Home::setupUI()
         ui->Locations->setChecked(false);
     });
 
+    // Bookings can be made up to OccupancyCalendar::kDaysAhead days out;
+    // the popup shows how full each day already is
+    bookingCalendar = new OccupancyCalendar(engine, this);
+    bookingDate = new QDateEdit(QDate::currentDate(), this);
+    bookingDate->setCalendarPopup(true);
+    bookingDate->setCalendarWidget(bookingCalendar);
+    bookingDate->setDateRange(bookingCalendar->minimumDate(), bookingCalendar->maximumDate());
+    bookingDate->setDisplayFormat("ddd, MMM d, yyyy");
+    connect(bookingDate, &QDateEdit::dateChanged, this, [this]() {
+        populateTimeSlots();
+    });
+
     //Hide elements
     ui->Table1_list->setVisible(false);
     ui->Reserve->setVisible(false);
+    bookingDate->setVisible(false);
 
     // Initialize additional UI components
     setupTableCapacityIndicators();
@@ -294,67 +425,24 @@ void Home::setupUI()
 
 void Home::setupTables()
 {
-    // Initialize table information
-    tables["Table1"] = TableInfo(4);
-    tables["Table2"] = TableInfo(4);
-    tables["Table3"] = TableInfo(4);
-    tables["Table4"] = TableInfo(4);
-    tables["Table5"] = TableInfo(4);
-    tables["Table6"] = TableInfo(4);
-    tables["Table7"] = TableInfo(4);
-    tables["Table8"] = TableInfo(4);
-    tables["Table9"] = TableInfo(4);
-    tables["Table10"] = TableInfo(4);
-    tables["Table11"] = TableInfo(4);
-    tables["Table12"] = TableInfo(4);
-    tables["Table13"] = TableInfo(8);
-    tables["Table14"] = TableInfo(8);
-
-    QString tableStyle = "QPushButton {"
-                         "    background: qlineargradient(spread:pad, x1:0, y1:0, x2:0, y2:1,"
-                         "                               stop:0 #FFFFFF, stop:1 #F5F5F5);"
-                         "    color: #2C3E50;"
-                         "    border-radius: 12px;"
-                         "    border: 1.5px solid #E0E0E0;"  // Lighter, subtle border
-                         "    font-size: 15px;"
-                         "    font-weight: 500;"  // Slightly bolder text
-                         "    padding: 12px 20px;"  // padding for better proportions
-                         "    box-shadow: 0 2px 4px rgba(0, 0, 0, 0.05);"  // Subtle shadow for depth
-                         "    transition: all 0.3s ease;"  // Smooth transition for all changes
-                         "}"
-                         "QPushButton:hover {"
-                         "    background: qlineargradient(spread:pad, x1:0, y1:0, x2:0, y2:1,"
-                         "                               stop:0 #4CAF50, stop:1 #45A049);"
-                         "    color: white;"
-                         "    border-color: #388E3C;"
-                         "    box-shadow: 0 4px 8px rgba(76, 175, 80, 0.2);"  // Green-tinted shadow on hover
-                         "    transform: translateY(-1px);"  // Slight lift effect
-                         "}"
-                         "QPushButton:pressed {"
-                         "    background: qlineargradient(spread:pad, x1:0, y1:0, x2:0, y2:1,"
-                         "                               stop:0 #388E3C, stop:1 #2E7D32);"
-                         "    color: white;"
-                         "    border-color: #2E7D32;"
-                         "    box-shadow: 0 2px 4px rgba(0, 0, 0, 0.1);"  // Reduced shadow when pressed
-                         "    transform: translateY(1px);"  // Slight press effect
-                         "}";
-
-    for (const auto &tableName : tables.keys()) {
-        QPushButton *tableButton = findChild<QPushButton *>(tableName);
+    // Initialize table information. Table1..Table12 seat 4, Table13 and
+    // Table14 are the 8 seat VIP tables.
+    for (int i = 1; i <= totalTables; i++) {
+        registerTable(QString("Table%1").arg(i), TableInfo(i >= 13 ? 8 : 4));
+    }
+
+    for (TableId id = 0; id < tables.size(); ++id) {
+        QPushButton *tableButton = this->tableButton(id);
         if (tableButton) {
-            tableButton->setStyleSheet(tableStyle);
             connect(tableButton, &QPushButton::clicked, this, &Home::handleTableClick);
         }
     }
 
+    setupTableJoins();
+
     // Load existing reservations and update appearances
     loadReservations();
-    for (const auto &tableName : tables.keys()) {
-        QPushButton *tableButton = findChild<QPushButton *>(tableName);
-        if (tableButton) {
-            updateTableAppearance(tableButton);
-        }
-    }
+    refreshTableAppearances();
 }
 
 void Home::handleTableClick()
@@ -363,134 +451,138 @@ void Home::handleTableClick()
     if (!clickedTable)
         return;
 
+    selectTable(tableIdFor(clickedTable));
+}
+
+void Home::selectTable(TableId id)
+{
+    if (!tables.contains(id))
+        return;
+
     // Store the previous selected table
-    QPushButton *prevTable = selectedTable;
+    TableId prevTable = selectedTable;
 
     // Update the selected table
-    selectedTable = clickedTable;
+    selectedTable = id;
 
-    // Update appearances for both previous and newly selected tables
-    if (prevTable) {
-        selectedTable = nullptr;  // Temporarily clear selection to get default appearance
+    // Only the previous and the newly selected tables change state
+    if (prevTable >= 0 && prevTable != id) {
         updateTableAppearance(prevTable);
-        selectedTable = clickedTable;  // Restore selection
     }
-
-    // Update appearance of newly clicked table
-    updateTableAppearance(clickedTable);
+    updateTableAppearance(id);
 
     // Show reservation prompt
-    showReservationPrompt(clickedTable);
+    showReservationPrompt(id);
 }
 
-void Home::updateTableAppearance(QPushButton *table)
+// Largest gap between two table buttons that still lets them be pushed together
+static const int kJoinGap = 50;
+
+static bool sideBySide(const QRect &a, const QRect &b)
 {
-    if (!table)
-        return;
+    const bool sameRow = a.top() <= b.bottom() && b.top() <= a.bottom();
+    const bool sameColumn = a.left() <= b.right() && b.left() <= a.right();
+    const int horizontalGap = std::max(a.left(), b.left()) - std::min(a.right(), b.right());
+    const int verticalGap = std::max(a.top(), b.top()) - std::min(a.bottom(), b.bottom());
+    return (sameRow && horizontalGap <= kJoinGap) || (sameColumn && verticalGap <= kJoinGap);
+}
 
-    const TableInfo &info = tables[table->objectName()];
-    QString styleSheet;
+void Home::setupTableJoins()
+{
+    // Neighbouring tables on the floor plan can be joined for larger parties
+    assigner.clearJoins();
+    for (TableId a = 0; a < tables.size(); ++a) {
+        QPushButton *first = tableButton(a);
+        if (!first)
+            continue;
+        for (TableId b = a + 1; b < tables.size(); ++b) {
+            QPushButton *second = tableButton(b);
+            if (second && sideBySide(first->geometry(), second->geometry()))
+                assigner.setJoinable(a, b);
+        }
+    }
+}
 
-    bool isReservedAtSelectedTime = false;
-    if (!ui->Table1_list->currentText().isEmpty()) {
-        QTime selectedTime = QTime::fromString(ui->Table1_list->currentText(), "hh:mm AP");
-        QDateTime selectedDateTime = QDateTime(QDateTime::currentDateTime().date(), selectedTime);
+bool Home::selectedSlot(int &day, int &slot) const
+{
+    if (ui->Table1_list->currentText().isEmpty())
+        return false;
 
-        for (const QDateTime &reservedTime : info.reservedTimes) {
-            if (reservedTime.time() == selectedTime) {
-                isReservedAtSelectedTime = true;
-                break;
-            }
+    QTime selectedTime = QTime::fromString(ui->Table1_list->currentText(), "hh:mm AP");
+    QDateTime selectedDateTime = QDateTime(bookingDate->date(), selectedTime);
+    if (!selectedDateTime.isValid())
+        return false;
+
+    EpochSeconds epoch = toEpoch(selectedDateTime);
+    day = engine.dayIndex(epoch);
+    slot = engine.slotIndex(epoch);
+    return slot >= 0;
+}
+
+void Home::refreshTableAppearances()
+{
+    // Fetch the busy-table bitset for the selected slot once for the whole floor
+    int day = 0;
+    int slot = -1;
+    const std::vector<SlotGrid::Word> *busy = nullptr;
+    if (selectedSlot(day, slot)) {
+        busy = &engine.slotGrid().busyTables(day, slot);
+    }
+
+    for (TableId id = 0; id < tables.size(); ++id) {
+        bool isReserved = false;
+        if (busy && id / SlotGrid::kWordBits < static_cast<int>(busy->size())) {
+            isReserved = ((*busy)[id / SlotGrid::kWordBits] >> (id % SlotGrid::kWordBits)) & 1;
         }
+        stageTableAppearance(id, isReserved);
     }
 
-    if (isReservedAtSelectedTime) {
-        // Reserved table style - Professional red theme
-        styleSheet = "QPushButton {"
-                     "    background: qlineargradient(spread:pad, x1:0, y1:0, x2:0, y2:1,"
-                     "                               stop:0 #FF5252, stop:1 #F44336);"
-                     "    color: white;"
-                     "    border-radius: 12px;"
-                     "    border: 1.5px solid #D32F2F;"
-                     "    font-size: 15px;"
-                     "    font-weight: 500;"
-                     "    padding: 12px 20px;"
-                     "    box-shadow: 0 2px 4px rgba(244, 67, 54, 0.2);"
-                     "    transition: all 0.3s ease;"
-                     "}"
-                     "QPushButton:hover {"
-                     "    background: qlineargradient(spread:pad, x1:0, y1:0, x2:0, y2:1,"
-                     "                               stop:0 #FF6B6B, stop:1 #FF5252);"
-                     "    box-shadow: 0 4px 8px rgba(244, 67, 54, 0.3);"
-                     "}"
-                     "QPushButton:pressed {"
-                     "    background: qlineargradient(spread:pad, x1:0, y1:0, x2:0, y2:1,"
-                     "                               stop:0 #D32F2F, stop:1 #C62828);"
-                     "    box-shadow: 0 2px 4px rgba(244, 67, 54, 0.1);"
-                     "}";
-    } else if (table == selectedTable) {
-        // Selected table style - Professional green theme
-        styleSheet = "QPushButton {"
-                     "    background: qlineargradient(spread:pad, x1:0, y1:0, x2:0, y2:1,"
-                     "                               stop:0 #4CAF50, stop:1 #45A049);"
-                     "    color: white;"
-                     "    border-radius: 12px;"
-                     "    border: 1.5px solid #388E3C;"
-                     "    font-size: 15px;"
-                     "    font-weight: 500;"
-                     "    padding: 12px 20px;"
-                     "    box-shadow: 0 2px 4px rgba(76, 175, 80, 0.2);"
-                     "    transition: all 0.3s ease;"
-                     "}"
-                     "QPushButton:hover {"
-                     "    background: qlineargradient(spread:pad, x1:0, y1:0, x2:0, y2:1,"
-                     "                               stop:0 #66BB6A, stop:1 #4CAF50);"
-                     "    box-shadow: 0 4px 8px rgba(76, 175, 80, 0.3);"
-                     "}"
-                     "QPushButton:pressed {"
-                     "    background: qlineargradient(spread:pad, x1:0, y1:0, x2:0, y2:1,"
-                     "                               stop:0 #388E3C, stop:1 #2E7D32);"
-                     "    box-shadow: 0 2px 4px rgba(76, 175, 80, 0.1);"
-                     "}";
-    } else {
-        // Available table style - Professional white theme
-        styleSheet = "QPushButton {"
-                     "    background: qlineargradient(spread:pad, x1:0, y1:0, x2:0, y2:1,"
-                     "                               stop:0 #FFFFFF, stop:1 #F5F5F5);"
-                     "    color: #2C3E50;"
-                     "    border-radius: 12px;"
-                     "    border: 1.5px solid #E0E0E0;"
-                     "    font-size: 15px;"
-                     "    font-weight: 500;"
-                     "    padding: 12px 20px;"
-                     "    box-shadow: 0 2px 4px rgba(0, 0, 0, 0.05);"
-                     "    transition: all 0.3s ease;"
-                     "}"
-                     "QPushButton:hover {"
-                     "    background: qlineargradient(spread:pad, x1:0, y1:0, x2:0, y2:1,"
-                     "                               stop:0 #4CAF50, stop:1 #45A049);"
-                     "    color: white;"
-                     "    border-color: #388E3C;"
-                     "    box-shadow: 0 4px 8px rgba(76, 175, 80, 0.2);"
-                     "}"
-                     "QPushButton:pressed {"
-                     "    background: qlineargradient(spread:pad, x1:0, y1:0, x2:0, y2:1,"
-                     "                               stop:0 #388E3C, stop:1 #2E7D32);"
-                     "    color: white;"
-                     "    border-color: #2E7D32;"
-                     "    box-shadow: 0 2px 4px rgba(76, 175, 80, 0.1);"
-                     "}";
-    }
-
-    table->setStyleSheet(styleSheet);
-}
-
-void Home::showReservationPrompt(QPushButton *table)
-{
-    if (!table)
+    // Only tables whose state differs from what is on screen get touched
+    floorRenderer.commit();
+}
+
+void Home::updateTableAppearance(TableId id)
+{
+    if (!tables.contains(id))
         return;
 
-    const TableInfo &info = tables[table->objectName()];
+    int day = 0;
+    int slot = -1;
+    bool isReservedAtSelectedTime = selectedSlot(day, slot)
+                                    && engine.slotGrid().isBusy(day, id, slot);
+    stageTableAppearance(id, isReservedAtSelectedTime);
+    floorRenderer.commit();
+}
+
+void Home::stageTableAppearance(TableId id, bool isReservedAtSelectedTime)
+{
+    FloorPlanRenderer::State state = 0;
+    if (isReservedAtSelectedTime)
+        state |= FloorPlanRenderer::Reserved;
+    if (id == selectedTable)
+        state |= FloorPlanRenderer::Selected;
+    if (id < filteredOut.size() && filteredOut[id])
+        state |= FloorPlanRenderer::FilteredOut;
+    if (tables[id].isVIP)
+        state |= FloorPlanRenderer::VIP;
+
+    // Large floors are drawn by the graphics view; its items skip repeats themselves
+    if (floorPlanView) {
+        floorPlanView->setTableState(id, state);
+        return;
+    }
+
+    if (QPushButton *button = tableButton(id)) {
+        floorRenderer.stage(id, button, state);
+    }
+}
+
+void Home::showReservationPrompt(TableId tableId)
+{
+    if (!tables.contains(tableId))
+        return;
+
+    const TableInfo &info = tables[tableId];
 
     // Store the current selection and time if they exist
     QString currentTime;
@@ -503,6 +595,7 @@ void Home::showReservationPrompt(QPushButton *table)
         // Before deleting, reparent the widgets we want to keep
         ui->Table1_list->setParent(this);
         ui->Reserve->setParent(this);
+        bookingDate->setParent(this);
         delete rightPanel;
     }
 
@@ -521,7 +614,7 @@ void Home::showReservationPrompt(QPushButton *table)
     panelLayout->setContentsMargins(20, 20, 20, 20);
 
     // Table Header Section
-    QLabel* tableHeader = new QLabel(QString("Table %1").arg(table->objectName().right(table->objectName().length() - 5)));
+    QLabel* tableHeader = new QLabel(QString("Table %1").arg(tables.name(tableId).mid(5)));
     tableHeader->setStyleSheet(
         "QLabel {"
         "    color: #1B4965;"
@@ -556,6 +649,33 @@ void Home::showReservationPrompt(QPushButton *table)
 
     panelLayout->addWidget(detailsWidget);
 
+    // Date Selection Section, heat shown for this table's size
+    QLabel* dateLabel = new QLabel("Select Date");
+    dateLabel->setStyleSheet(
+        "color: #1B4965;"
+        "font-size: 16px;"
+        "font-weight: bold;"
+        "margin-top: 8px;");
+    panelLayout->addWidget(dateLabel);
+
+    bookingCalendar->setCapacityClass(OccupancySummary::classFor(info.seats));
+    bookingCalendar->refresh();
+    bookingDate->setParent(rightPanel);
+    bookingDate->setFixedHeight(40);
+    bookingDate->setStyleSheet(
+        "QDateEdit {"
+        "    background-color: white;"
+        "    border: 1px solid #DEE2E6;"
+        "    border-radius: 6px;"
+        "    padding: 8px 12px;"
+        "    font-size: 14px;"
+        "    color: #2C3E50;"
+        "}"
+        "QDateEdit:hover {"
+        "    border-color: #1B4965;"
+        "}");
+    panelLayout->addWidget(bookingDate);
+
     // Time Selection Section
     QLabel* timeLabel = new QLabel("Select Time");
     timeLabel->setStyleSheet(
@@ -679,6 +799,29 @@ void Home::showReservationPrompt(QPushButton *table)
     ui->Reserve->setCursor(Qt::PointingHandCursor);
     panelLayout->addWidget(ui->Reserve);
 
+    // Closing a table re-seats the chosen day's bookings elsewhere
+    const bool inService = assigner.isInService(tableId);
+    QPushButton* serviceButton = new QPushButton(inService ? "Take Out of Service" : "Return to Service", rightPanel);
+    serviceButton->setCursor(Qt::PointingHandCursor);
+    serviceButton->setStyleSheet(
+        "QPushButton {"
+        "    background-color: white;"
+        "    color: #DC3545;"
+        "    border: 1px solid #DC3545;"
+        "    border-radius: 6px;"
+        "    padding: 8px;"
+        "    font-size: 14px;"
+        "}"
+        "QPushButton:hover {"
+        "    background-color: #FFF5F5;"
+        "}");
+    connect(serviceButton, &QPushButton::clicked, this, [this, tableId, inService]() {
+        setTableInService(tableId, !inService);
+        // The panel owns this button, so rebuild it once the click has returned
+        QMetaObject::invokeMethod(this, [this, tableId]() { showReservationPrompt(tableId); }, Qt::QueuedConnection);
+    });
+    panelLayout->addWidget(serviceButton);
+
     // Add stretch to push everything up
     panelLayout->addStretch();
 
@@ -686,6 +829,7 @@ void Home::showReservationPrompt(QPushButton *table)
     rightPanel->show();
     ui->Table1_list->setVisible(true);
     ui->Reserve->setVisible(true);
+    bookingDate->setVisible(true);
 }
 
 
@@ -697,9 +841,10 @@ void Home::populateTimeSlots()
     ui->Table1_list->clear();
 
     QDateTime currentTime = QDateTime::currentDateTime();
+    const QDate date = bookingDate->date();
     for (int hour = 11; hour <= 22; hour++) { // Restaurant hours: 11 AM to 10 PM
         for (int minute = 0; minute < 60; minute += 30) {
-            QDateTime slotTime = QDateTime(currentTime.date(), QTime(hour, minute));
+            QDateTime slotTime = QDateTime(date, QTime(hour, minute));
             if (slotTime > currentTime) {
                 QString timeStr = slotTime.toString("hh:mm AP");
                 ui->Table1_list->addItem(timeStr);
@@ -708,12 +853,7 @@ void Home::populateTimeSlots()
     }
 
     // Update all table appearances after populating time slots
-    for (const auto &tableName : tables.keys()) {
-        QPushButton *tableButton = findChild<QPushButton *>(tableName);
-        if (tableButton) {
-            updateTableAppearance(tableButton);
-        }
-    }
+    refreshTableAppearances();
 }
 
 
@@ -726,83 +866,427 @@ void Home::populateTimeSlots()
 
 void Home::on_Reserve_clicked()
 {
-    if (!selectedTable || ui->Table1_list->currentText().isEmpty()) {
+    if (!tables.contains(selectedTable) || ui->Table1_list->currentText().isEmpty()) {
         QMessageBox::warning(this, "Reservation Error", "Please select a table and time slot.");
         return;
     }
 
-    QString tableId = selectedTable->objectName();
-    QDateTime currentTime = QDateTime::currentDateTime();
+    TableId tableId = selectedTable;
+
     QTime selectedTime = QTime::fromString(ui->Table1_list->currentText(), "hh:mm AP");
-    QDateTime reservationTime = QDateTime(currentTime.date(), selectedTime);
-
-    // Check if the time is already reserved
-    //change this to check db times
-    bool timeAlreadyReserved = false;
-    for (const QDateTime &existingTime : tables[tableId].reservedTimes) {
-        if (existingTime.date() == reservationTime.date() &&
-            existingTime.time() == reservationTime.time()) {
-            timeAlreadyReserved = true;
-            break;
+    bookTables({tableId}, QDateTime(bookingDate->date(), selectedTime));
+}
+
+void Home::bookTables(const std::vector<TableId> &tableIds, const QDateTime &reservationTime)
+{
+    for (TableId tableId : tableIds) {
+        if (!assigner.isInService(tableId)) {
+            QMessageBox::warning(this, "Reservation Error",
+                                 QString("Table %1 is out of service.").arg(tables.name(tableId).mid(5)));
+            return;
         }
     }
-    //change to check db times
-    if (timeAlreadyReserved) {
-        QMessageBox::warning(this, "Reservation Error", "This time slot is already reserved.");
+
+    // The engine rejects a table if its sitting overlaps an existing booking;
+    // a joined party then gives back the tables it already claimed
+    const EpochSeconds start = toEpoch(reservationTime);
+    QVector<TableBooking> bookings;
+    for (std::size_t i = 0; i < tableIds.size(); ++i) {
+        const TableId tableId = tableIds[i];
+        const EpochSeconds end = start + engine.sittingFor(tableId);
+        if (!engine.reserve(tableId, start, end)) {
+            for (std::size_t claimed = 0; claimed < i; ++claimed) {
+                engine.cancel(tableIds[claimed], start);
+            }
+
+            const auto clashes = engine.overlapping(tableId, start, end);
+            QString message = "This time slot is already reserved.";
+            if (!clashes.empty()) {
+                message = QString("Table %1 is booked from %2 to %3.")
+                              .arg(tables.name(tableId).mid(5),
+                                   fromEpoch(clashes.front().first).toString("h:mm AP"),
+                                   fromEpoch(clashes.front().second).toString("h:mm AP"));
+            }
+            QMessageBox::warning(this, "Reservation Error", message);
+            return;
+        }
+        bookings.append({tables.name(tableId), end - start});
+    }
+
+    // Save the reservation to the database. The inserts are group-committed
+    // with any other writes in the next few milliseconds; the engine already
+    // holds the tables so they cannot be booked twice in the meantime.
+    saveReservationToDatabase(bookings, reservationTime, currentUser,
+                              [this, tableIds, start, reservationTime](bool ok, const QString &conflictTable,
+                                                                       const QDateTime &conflictingSlot) {
+        if (!ok) {
+            for (TableId tableId : tableIds) {
+                engine.cancel(tableId, start);
+            }
+            if (conflictingSlot.isValid()) {
+                // Booked from another terminal since this one loaded
+                QMessageBox::warning(this, "Reservation Error",
+                                     QString("%1 is already reserved at %2.")
+                                         .arg(conflictTable, conflictingSlot.toString("h:mm AP")));
+            } else {
+                QMessageBox::warning(this, "Database Error", "Failed to save reservation to the database.");
+            }
+            return;
+        }
+
+        for (TableId tableId : tableIds) {
+            tables[tableId].isReserved = true;
+            tables[tableId].reservationTime = reservationTime;
+            journalReservation(ReservationJournal::Reserve, tableId, reservationTime);
+            updateTableAppearance(tableId);
+        }
+        populateTimeSlots(); // Refresh the available time slots
+        bookingCalendar->refresh();
+
+        QMessageBox::information(this, "Reservation Confirmed", "Reservation successfully made.");
+    });
+}
+
+void Home::assignTableForParty()
+{
+    if (ui->Table1_list->count() == 0) {
+        populateTimeSlots();
+    }
+    if (ui->Table1_list->currentText().isEmpty()) {
+        QMessageBox::warning(this, "Reservation Error", "There are no time slots left on this date.");
         return;
     }
 
-    // Add the new reservation
-    //make query to add to db
-    tables[tableId].isReserved = true;
-    tables[tableId].reservationTime = reservationTime;
-    tables[tableId].reservedTimes.append(reservationTime);
+    QTime selectedTime = QTime::fromString(ui->Table1_list->currentText(), "hh:mm AP");
+    QDateTime reservationTime(bookingDate->date(), selectedTime);
+    const int party = partySize->value();
+
+    const EpochSeconds start = toEpoch(reservationTime);
+    TableAssigner::Assignment assignment = assigner.assign(party, start);
+    if (!assignment.isValid()) {
+        // Nothing is free as things stand; see whether moving a few bookings makes room
+        ReseatingSolver::Request request;
+        request.day = engine.dayIndex(start);
+        request.notBefore = toEpoch(QDateTime::currentDateTime());
+        request.outOfService = outOfServiceTables();
+        request.additions.push_back({party, start});
+        const ReseatingSolver::Plan plan = reseater.solve(request);
+        if (!plan.feasible) {
+            QMessageBox::warning(this, "Reservation Error",
+                                 QString("No table or group of tables can seat %1 guests at %2.")
+                                     .arg(party).arg(reservationTime.toString("h:mm AP")));
+            return;
+        }
 
-    // Save the reservation to the database
-    if (!saveReservationToDatabase(tableId, reservationTime, currentUser)) {
-        QMessageBox::warning(this, "Database Error", "Failed to save reservation to the database.");
+        const ReseatingSolver::Move seat = plan.moves.back();  // The new booking comes last
+        const QString question = QString("No table is free for %1 guests at %2. Moving %3 booking(s) "
+                                         "frees Table %4:\n\n%5")
+                                     .arg(party).arg(reservationTime.toString("h:mm AP"))
+                                     .arg(plan.movedBookings).arg(tables.name(seat.to).mid(5))
+                                     .arg(describeMoves(plan));
+        if (QMessageBox::question(this, "Re-seat Bookings", question) != QMessageBox::Yes)
+            return;
+
+        applyReseating(plan, [this, seat, reservationTime](bool moved) {
+            if (moved)
+                bookTables({seat.to}, reservationTime);
+        });
         return;
     }
 
-    saveReservations();
-    updateTableAppearance(selectedTable);
-    populateTimeSlots(); // Refresh the available time slots
+    // A single table goes through the usual prompt so the host can confirm it
+    if (assignment.tables.size() == 1) {
+        selectTable(assignment.tables.front());
+        return;
+    }
+
+    QStringList names;
+    for (TableId id : assignment.tables) {
+        names << tables.name(id).mid(5);
+    }
+    const QString question = QString("Join tables %1 to seat %2 guests at %3?")
+                                 .arg(names.join(" + ")).arg(party).arg(reservationTime.toString("h:mm AP"));
+    if (QMessageBox::question(this, "Join Tables", question) != QMessageBox::Yes)
+        return;
 
-    QMessageBox::information(this, "Reservation Confirmed", "Reservation successfully made.");
+    bookTables(assignment.tables, reservationTime);
 }
+void Home::setTableInService(TableId id, bool inService)
+{
+    const QDateTime now = QDateTime::currentDateTime();
+    if (inService) {
+        assigner.setInService(id, true);
+        tables[id].inService = true;
+        journalReservation(ReservationJournal::InService, id, now);
+        return;
+    }
 
+    // Every day still ahead with a booking on the table is re-planned;
+    // bookings that already started stay where they were
+    std::set<int> days;
+    const ReservationEngine::SlotIndex &booked = engine.reservations(id);
+    for (auto it = booked.lower_bound(toEpoch(now)); it != booked.end(); ++it) {
+        days.insert(engine.dayIndex(it->first));
+    }
 
-bool Home::saveReservationToDatabase(const QString &tableId, const QDateTime &reservationTime, const QString &username)
-{
-    // Ensure database connection
-    QSqlDatabase logindb = QSqlDatabase::database();
+    ReseatingSolver::Request request;
+    request.notBefore = toEpoch(now);
+    request.outOfService = outOfServiceTables();
+    request.outOfService.push_back(id);
+    ReseatingSolver::Plan plan;
+    plan.feasible = true;
+    QDate stuck;
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    for (int day : days) {
+        request.day = day;
+        const ReseatingSolver::Plan dayPlan = reseater.solve(request);
+        if (!dayPlan.feasible) {
+            plan.feasible = false;
+            stuck = fromEpoch(engine.slotStart(day, 0)).date();
+            break;
+        }
+        plan.moves.insert(plan.moves.end(), dayPlan.moves.begin(), dayPlan.moves.end());
+        plan.movedBookings += dayPlan.movedBookings;
+    }
+    QApplication::restoreOverrideCursor();
 
-    // Prepare and execute the SQL query
-    QSqlQuery query(logindb);
-    query.prepare("INSERT INTO reservations (table_id, reservation_time, username) "
-                  "VALUES (:table_id, :reservation_time, :username)");
-    query.bindValue(":table_id", tableId);
-    query.bindValue(":reservation_time", reservationTime.toString(Qt::ISODate));
-    query.bindValue(":username", username);
+    const QString tableName = QString("Table %1").arg(tables.name(id).mid(5));
+    if (!plan.feasible) {
+        QMessageBox::warning(this, "Out of Service",
+                             QString("The bookings on %1 for %2 cannot all be moved to other tables.")
+                                 .arg(tableName, stuck.toString("MMM d")));
+        return;
+    }
+    if (!plan.moves.empty()) {
+        const QString question = QString("Taking %1 out of service moves %2 booking(s):\n\n%3")
+                                     .arg(tableName).arg(plan.movedBookings).arg(describeMoves(plan));
+        if (QMessageBox::question(this, "Out of Service", question) != QMessageBox::Yes)
+            return;
+    }
 
-    if (!query.exec()) {
-        qDebug() << "Failed to insert reservation:" << query.lastError().text();
-        return false;
+    // Closed straight away so nothing books it while the moves are saved
+    assigner.setInService(id, false);
+    applyReseating(plan, [this, id, now](bool moved) {
+        if (!moved) {
+            assigner.setInService(id, true);
+            return;
+        }
+        tables[id].inService = false;
+        journalReservation(ReservationJournal::OutOfService, id, now);
+    });
+}
+
+std::vector<TableId> Home::outOfServiceTables() const
+{
+    std::vector<TableId> result;
+    for (TableId id = 0; id < tables.size(); ++id) {
+        if (!assigner.isInService(id))
+            result.push_back(id);
     }
+    return result;
+}
 
-    return true;
+QString Home::describeMoves(const ReseatingSolver::Plan &plan) const
+{
+    QStringList lines;
+    for (const ReseatingSolver::Move &move : plan.moves) {
+        if (move.from < 0)
+            continue;
+        lines << QString("%1  Table %2 \u2192 Table %3")
+                     .arg(fromEpoch(move.start).toString("MMM d, h:mm AP"),
+                          tables.name(move.from).mid(5), tables.name(move.to).mid(5));
+    }
+    return lines.join("\n");
 }
 
+void Home::applyReseating(const ReseatingSolver::Plan &plan, const std::function<void(bool)> &done)
+{
+    // Additions are booked by the caller once the moves are saved
+    std::vector<ReseatingSolver::Move> moves;
+    std::vector<ReservationEngine::Interval> originals;
+    for (const ReseatingSolver::Move &move : plan.moves) {
+        if (move.from < 0)
+            continue;
+        const ReservationEngine::SlotIndex &booked = engine.reservations(move.from);
+        auto original = booked.find(move.start);
+        if (original == booked.end()) {
+            QMessageBox::warning(this, "Re-seat Bookings", "The bookings changed while the plan was made.");
+            done(false);
+            return;
+        }
+        moves.push_back(move);
+        originals.push_back(*original);
+    }
 
+    // Free every source table first so chains and swaps never collide
+    for (const ReseatingSolver::Move &move : moves) {
+        engine.cancel(move.from, move.start);
+    }
+    std::size_t placed = 0;
+    while (placed < moves.size()
+           && engine.reserve(moves[placed].to, moves[placed].start, moves[placed].end)) {
+        ++placed;
+    }
+    if (placed < moves.size()) {
+        undoReseating(moves, originals, placed);
+        QMessageBox::warning(this, "Re-seat Bookings",
+                             QString("Table %1 is no longer free at %2.")
+                                 .arg(tables.name(moves[placed].to).mid(5),
+                                      fromEpoch(moves[placed].start).toString("h:mm AP")));
+        done(false);
+        return;
+    }
 
+    // The journal only hears about the moves once the database has them
+    moveReservationsInDatabase(moves, [this, moves, originals, done](bool ok) {
+        if (!ok) {
+            undoReseating(moves, originals, moves.size());
+            QMessageBox::warning(this, "Database Error", "The moved reservations could not be saved.");
+        } else {
+            for (const ReseatingSolver::Move &move : moves) {
+                journalReservation(ReservationJournal::Cancel, move.from, fromEpoch(move.start));
+                journalReservation(ReservationJournal::Reserve, move.to, fromEpoch(move.start));
+            }
+        }
+        refreshTableAppearances();
+        bookingCalendar->refresh();
+        done(ok);
+    });
+}
 
+void Home::undoReseating(const std::vector<ReseatingSolver::Move> &moves,
+                         const std::vector<ReservationEngine::Interval> &originals, std::size_t placed)
+{
+    for (std::size_t i = 0; i < placed; ++i) {
+        engine.cancel(moves[i].to, moves[i].start);
+    }
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        engine.reserve(moves[i].from, originals[i].first, originals[i].second);
+    }
+}
 
+void Home::moveReservationsInDatabase(const std::vector<ReseatingSolver::Move> &moves,
+                                      const std::function<void(bool)> &done)
+{
+    struct Row
+    {
+        QString from;
+        QString to;
+        qint64 time;
+        EpochSeconds length;
+    };
+    QVector<Row> rows;
+    for (const ReseatingSolver::Move &move : moves) {
+        rows.append({tables.name(move.from), tables.name(move.to), move.start, move.end - move.start});
+    }
 
+    // One job, so the queue's savepoint makes it all or nothing. Rows are
+    // parked under a temporary table_id first: moving them straight across
+    // would trip the UNIQUE (table_id, slot_start) index in a swap. Each
+    // destination is checked once every moved row is out of the way, in
+    // case another terminal booked it meanwhile.
+    writeQueue->enqueue([rows]() {
+        QSqlQuery &move = StatementCache::statement(
+            "UPDATE reservations SET table_id = :to "
+            "WHERE table_id = :from AND reservation_time = :reservation_time");
+        for (int phase = 0; phase < 2; ++phase) {
+            for (const Row &row : rows) {
+                const QString parked = "moving:" + row.to;
+                if (phase == 1) {
+                    QSqlQuery &taken = StatementCache::statement(
+                        "SELECT 1 FROM reservations WHERE table_id = :table_id "
+                        "AND reservation_time > :earliest AND reservation_time < :latest");
+                    taken.bindValue(":table_id", row.to);
+                    taken.bindValue(":earliest", row.time - row.length);
+                    taken.bindValue(":latest", row.time + row.length);
+                    if (!taken.exec() || taken.next()) {
+                        qDebug() << "Cannot move reservation to" << row.to << taken.lastError().text();
+                        return false;
+                    }
+                }
 
+                move.bindValue(":to", phase == 0 ? parked : row.to);
+                move.bindValue(":from", phase == 0 ? row.from : parked);
+                move.bindValue(":reservation_time", row.time);
+                if (!move.exec() || move.numRowsAffected() != 1) {
+                    qDebug() << "Failed to move reservation:" << row.from << row.time << move.lastError().text();
+                    return false;
+                }
+            }
+        }
+        return true;
+    }, done);
+}
 
+// Inserts one booking unless another on the table starts less than
+// `length` away. Every booking on a table lasts that table's sitting, so
+// that is exactly an overlap; the check and the insert are one statement
+// inside the write transaction, so another terminal cannot slip in between.
+// The UNIQUE (table_id, slot_start) index stays as a backstop. On a clash
+// `holder` receives the existing booking's time; on an error it stays 0.
+static bool insertReservation(const QString &tableId, qint64 time, EpochSeconds length,
+                              const QString &username, qint64 &holder)
+{
+    // Prepared once per connection, rebound per booking. A clash is a
+    // no-op rather than an error, so nothing here ever retries.
+    QSqlQuery &query = StatementCache::statement(
+        "INSERT INTO reservations (table_id, reservation_time, username) "
+        "SELECT :table_id, :reservation_time, :username "
+        "WHERE NOT EXISTS (SELECT 1 FROM reservations WHERE table_id = :same_table "
+        "                  AND reservation_time > :earliest AND reservation_time < :latest) "
+        "ON CONFLICT (table_id, slot_start) DO NOTHING");
+    query.bindValue(":table_id", tableId);
+    query.bindValue(":reservation_time", time);
+    query.bindValue(":username", username);
+    query.bindValue(":same_table", tableId);
+    query.bindValue(":earliest", time - length);
+    query.bindValue(":latest", time + length);
 
+    if (!query.exec()) {
+        qDebug() << "Failed to insert reservation:" << query.lastError().text();
+        return false;
+    }
+    if (query.numRowsAffected() > 0)
+        return true;
+
+    // Only the conflict path pays for looking up who holds the table
+    QSqlQuery &existing = StatementCache::statement(
+        "SELECT reservation_time FROM reservations "
+        "WHERE table_id = :table_id AND reservation_time > :earliest AND reservation_time < :latest "
+        "ORDER BY reservation_time LIMIT 1");
+    existing.bindValue(":table_id", tableId);
+    existing.bindValue(":earliest", time - length);
+    existing.bindValue(":latest", time + length);
+    holder = existing.exec() && existing.next() ? existing.value(0).toLongLong() : time;
+    return false;
+}
 
+void Home::saveReservationToDatabase(const QVector<TableBooking> &bookings, const QDateTime &reservationTime,
+                                     const QString &username,
+                                     const std::function<void(bool, const QString &, const QDateTime &)> &done)
+{
+    struct Conflict
+    {
+        QString table;
+        qint64 time = 0;
+    };
 
+    const qint64 time = toEpoch(reservationTime);
+    auto conflict = std::make_shared<Conflict>();
+    writeQueue->enqueue([bookings, time, username, conflict]() {
+        // A failed insert fails the job, and the queue rolls back the tables
+        // already written
+        for (const TableBooking &booking : bookings) {
+            if (!insertReservation(booking.tableId, time, booking.length, username, conflict->time)) {
+                conflict->table = booking.tableId;
+                return false;
+            }
+        }
+        return true;
+    }, [done, conflict](bool ok) {
+        done(ok, conflict->table, conflict->time != 0 ? fromEpoch(conflict->time) : QDateTime());
+    });
+}
 
 void Home::on_Menu_clicked()
 {
@@ -821,39 +1305,81 @@ void Home::on_Logout_clicked()
 
 void Home::resetTableStyles()
 {
-    for (auto it = tables.begin(); it != tables.end(); ++it) {
-        QPushButton *tableButton = findChild<QPushButton *>(it.key());
-        if (tableButton) {
-            tableButton->setStyleSheet("background-color: white; border: 2px solid grey;");
+    // Clear the filters and redraw every table from scratch
+    filteredOut.fill(false, tables.size());
+    floorRenderer.invalidate();
+    refreshTableAppearances();
+}
+
+
+QJsonObject Home::tableReservationsJson(TableId id) const
+{
+    const TableInfo &info = tables[id];
+    QJsonObject tableObj;
+    tableObj["seats"] = info.seats;
+    tableObj["isReserved"] = info.isReserved;
+    tableObj["reservationTime"] = info.reservationTime.toString(Qt::ISODate);
+    tableObj["customerName"] = info.customerName;
+
+    // Save the list of reserved times
+    QJsonArray reservedTimesArray;
+    for (const auto &slot : engine.reservations(id)) {
+        reservedTimesArray.append(fromEpoch(slot.first).toString(Qt::ISODate));
+    }
+    tableObj["reservedTimes"] = reservedTimesArray;
+    return tableObj;
+}
+
+void Home::saveReservations()
+{
+    // Full snapshot; the journal only has to hold what happened after it
+    journal->sync();
+
+    QVector<ReservationSnapshot::TableSource> snapshot;
+    snapshot.reserve(tables.size());
+    for (TableId id = 0; id < tables.size(); ++id) {
+        const TableInfo &info = tables[id];
+        ReservationSnapshot::TableSource table{
+            tables.name(id), info.seats, info.isVIP, info.isReserved, info.inService,
+            info.reservationTime.isValid() ? toEpoch(info.reservationTime) : ReservationSnapshot::kNoTime,
+            info.customerName, {}};
+        const ReservationEngine::SlotIndex &slots = engine.reservations(id);
+        table.times.reserve(int(slots.size()));
+        for (const auto &slot : slots) {
+            table.times.append(slot.first);
         }
+        snapshot.append(table);
+    }
+
+    if (ReservationSnapshot::write("reservations.snap", snapshot)) {
+        journal->reset();
+    } else {
+        qDebug() << "Failed to write the reservation snapshot";
     }
 }
 
+void Home::journalReservation(ReservationJournal::Op op, TableId id, const QDateTime &time)
+{
+    // One fixed-size record per change instead of rewriting the snapshot
+    if (!journal->append({op, id, toEpoch(time), userId})) {
+        qDebug() << "Failed to append to the reservation journal, writing a snapshot";
+        saveReservations();
+    }
+}
 
-void Home::saveReservations()
+void Home::applyJournalRecord(const ReservationJournal::Record &record)
 {
-    QFile file("reservations.json");
-    if (file.open(QIODevice::WriteOnly)) {
-        QJsonObject rootObj;
-        for (auto it = tables.begin(); it != tables.end(); ++it) {
-            QJsonObject tableObj;
-            tableObj["seats"] = it.value().seats;
-            tableObj["isReserved"] = it.value().isReserved;
-            tableObj["reservationTime"] = it.value().reservationTime.toString(Qt::ISODate);
-            tableObj["customerName"] = it.value().customerName;
-
-            // Save the list of reserved times
-            QJsonArray reservedTimesArray;
-            for (const QDateTime &time : it.value().reservedTimes) {
-                reservedTimesArray.append(time.toString(Qt::ISODate));
-            }
-            tableObj["reservedTimes"] = reservedTimesArray;
+    if (!tables.contains(record.table)) return;
 
-            rootObj[it.key()] = tableObj;
+    if (record.op == ReservationJournal::Reserve) {
+        if (engine.restore(record.table, record.time)) {
+            tables[record.table].isReserved = true;
+            tables[record.table].reservationTime = fromEpoch(record.time);
         }
-
-        QJsonDocument doc(rootObj);
-        file.write(doc.toJson());
+    } else if (record.op == ReservationJournal::Cancel) {
+        engine.cancel(record.table, record.time);
+    } else {
+        tables[record.table].inService = record.op == ReservationJournal::InService;
     }
 }
 //--------
@@ -888,50 +1414,155 @@ void Home::on_ReservationList_clicked()
 
 void Home::loadReservations()
 {
-    QFile file("reservations.json");
-    if (file.open(QIODevice::ReadOnly)) {
-        QByteArray data = file.readAll();
-        QJsonDocument doc = QJsonDocument::fromJson(data);
-        QJsonObject root = doc.object();
-
-        for (const QString &tableId : root.keys()) {
-            QJsonObject tableObj = root[tableId].toObject();
-            TableInfo table(tableObj["seats"].toInt());
-            table.isReserved = tableObj["isReserved"].toBool();
-            table.reservationTime = QDateTime::fromString(
-                tableObj["reservationTime"].toString(), Qt::ISODate);
-            table.customerName = tableObj["customerName"].toString();
-
-            // Load the reserved times
-            QJsonArray reservedTimesArray = tableObj["reservedTimes"].toArray();
-            for (const QJsonValue &timeValue : reservedTimesArray) {
-                table.reservedTimes.append(
-                    QDateTime::fromString(timeValue.toString(), Qt::ISODate));
+    engine.clearReservations();
+
+    ReservationSnapshot snapshot;
+    bool imported = false;
+    if (snapshot.open("reservations.snap")) {
+        // Read in place from the mapping: no JSON and no date parsing
+        for (int i = 0; i < snapshot.tableCount(); ++i) {
+            const ReservationSnapshot::Table entry = snapshot.table(i);
+            TableInfo table(entry.seats);
+            table.isVIP = entry.isVIP;
+            table.isReserved = entry.isReserved;
+            table.inService = entry.inService;
+            if (entry.reservationTime != ReservationSnapshot::kNoTime) {
+                table.reservationTime = fromEpoch(entry.reservationTime);
+            }
+            table.customerName = entry.customerName;
+
+            TableId engineId = registerTable(entry.name, table);
+            for (int t = 0; t < entry.timeCount; ++t) {
+                engine.restore(engineId, entry.times[t]);
             }
+        }
+        snapshot.close();
+    } else {
+        imported = importReservationsJson("reservations.json");
+    }
+
+    // Changes made since that snapshot. Table ids in the journal are stable
+    // across runs because setupTables always registers Table1..N first.
+    journal->replay([this](const ReservationJournal::Record &record) {
+        applyJournalRecord(record);
+    });
+
+    for (TableId id = 0; id < tables.size(); ++id) {
+        assigner.setInService(id, tables[id].inService);
+    }
+
+    // First start after the JSON era: write the binary snapshot once
+    if (imported) {
+        saveReservations();
+    }
+}
 
-            tables[tableId] = table;
+bool Home::importReservationsJson(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QByteArray data = file.readAll();
+    QJsonDocument doc = QJsonDocument::fromJson(data);
+    QJsonObject root = doc.object();
+
+    for (const QString &tableId : root.keys()) {
+        QJsonObject tableObj = root[tableId].toObject();
+        TableInfo table(tableObj["seats"].toInt());
+        table.isReserved = tableObj["isReserved"].toBool();
+        table.reservationTime = QDateTime::fromString(
+            tableObj["reservationTime"].toString(), Qt::ISODate);
+        table.customerName = tableObj["customerName"].toString();
+
+        // Load the reserved times
+        TableId engineId = registerTable(tableId, table);
+        QJsonArray reservedTimesArray = tableObj["reservedTimes"].toArray();
+        for (const QJsonValue &timeValue : reservedTimesArray) {
+            QDateTime time = QDateTime::fromString(timeValue.toString(), Qt::ISODate);
+            if (time.isValid()) {
+                engine.restore(engineId, toEpoch(time));
+            }
         }
     }
+    return true;
 }
 
+bool Home::exportReservationsJson(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QJsonObject rootObj;
+    for (TableId id = 0; id < tables.size(); ++id) {
+        rootObj[tables.name(id)] = tableReservationsJson(id);
+    }
+    return file.write(QJsonDocument(rootObj).toJson()) >= 0;
+}
 
 bool Home::isTableAvailable(const QString &tableId, const QDateTime &requestedTime)
 {
-    if (tables.contains(tableId)) {
-        const TableInfo &table = tables[tableId];
-        return !table.isReserved || table.reservationTime != requestedTime;
+    TableId id = tables.id(tableId);
+    if (tables.contains(id)) {
+        return engine.isFree(id, toEpoch(requestedTime));
     }
     return false;
 }
 
+TableId Home::registerTable(const QString &tableName, const TableInfo &info)
+{
+    // The engine hands out the dense id; the store keeps the Qt-side details
+    TableId id = engine.addTable(tableName.toStdString(), info.seats, info.isVIP, info.minSpend);
+    if (tables.contains(id) && tables.name(id) != tableName) {
+        invalidateTableButtons();
+    }
+    tables.set(id, tableName, info);
+    return id;
+}
+
+QPushButton *Home::tableButton(TableId id)
+{
+    if (!tables.contains(id))
+        return nullptr;
+
+    // Each button is looked up in the widget tree once, the first time it is needed
+    if (tableButtons.size() < tables.size()) {
+        tableButtons.resize(tables.size());
+    }
+    TableButtonHandle &handle = tableButtons[id];
+    if (!handle.resolved) {
+        handle.button = findChild<QPushButton *>(tables.name(id));
+        handle.resolved = true;
+    }
+    return handle.button;
+}
+
+void Home::invalidateTableButtons()
+{
+    // Call whenever buttons are created, renamed or destroyed
+    tableButtons.clear();
+}
+
+TableId Home::tableIdFor(const QPushButton *table) const
+{
+    return table ? tables.id(table->objectName()) : -1;
+}
+
 void Home::updateTableStatus()
 {
     // Check for expired reservations and mark them as available
-    for (auto it = tables.begin(); it != tables.end(); ++it) {
-        if (it.value().isReserved && it.value().reservationTime <= QDateTime::currentDateTime()) {
-            it.value().isReserved = false; // Mark as available if reservation time has passed
+    QDateTime currentDateTime = QDateTime::currentDateTime();
+    for (TableId id = 0; id < tables.size(); ++id) {
+        TableInfo &info = tables[id];
+        if (info.isReserved && info.reservationTime <= currentDateTime) {
+            info.isReserved = false; // Mark as available if reservation time has passed
         }
     }
+
+    // The bookable range starts today, so it moves on at midnight
+    bookingCalendar->refresh();
+    bookingDate->setDateRange(bookingCalendar->minimumDate(), bookingCalendar->maximumDate());
 }
 
 
@@ -988,12 +1619,7 @@ std::string Home::displayTableStatus()
 void Home::on_Table1_list_currentTextChanged(const QString &text)
 {
     // Update the appearance of all tables when a new time is selected
-    for (const auto &tableName : tables.keys()) {
-        QPushButton *tableButton = findChild<QPushButton *>(tableName);
-        if (tableButton) {
-            updateTableAppearance(tableButton);
-        }
-    }
+    refreshTableAppearances();
 }
 
 
@@ -1029,7 +1655,7 @@ void Home::setupLegend()
 void Home::setupFilters()
 {
     QWidget* filterBar = new QWidget(this);
-    filterBar->setGeometry(700, 70, 500, 40);
+    filterBar->setGeometry(700, 70, 660, 40);
     QHBoxLayout* filterLayout = new QHBoxLayout(filterBar);
     filterLayout->setSpacing(10);
     filterLayout->setContentsMargins(0, 0, 0, 0);
@@ -1078,6 +1704,40 @@ void Home::setupFilters()
     filterLayout->addSpacing(20);
     filterLayout->addWidget(capacityLabel);
     filterLayout->addWidget(capacityFilter);
+    filterLayout->addSpacing(20);
+
+    // Party size for automatic table assignment
+    QLabel* partyLabel = new QLabel("Party:");
+    partyLabel->setStyleSheet(filterStyle);
+    partySize = new QSpinBox(filterBar);
+    partySize->setRange(1, 24);
+    partySize->setValue(2);
+    partySize->setStyleSheet(
+        "QSpinBox {"
+        "    background-color: white;"
+        "    border: 1px solid #DEE2E6;"
+        "    border-radius: 6px;"
+        "    padding: 5px 10px;"
+        "    color: #2C3E50;"
+        "    font-size: 13px;"
+        "}");
+    QPushButton* findTable = new QPushButton("Find Table", filterBar);
+    findTable->setCursor(Qt::PointingHandCursor);
+    findTable->setStyleSheet(
+        "QPushButton {"
+        "    background-color: #1B4965;"
+        "    color: white;"
+        "    border: none;"
+        "    border-radius: 6px;"
+        "    padding: 6px 14px;"
+        "    font-size: 13px;"
+        "}"
+        "QPushButton:hover {"
+        "    background-color: #163A52;"
+        "}");
+    filterLayout->addWidget(partyLabel);
+    filterLayout->addWidget(partySize);
+    filterLayout->addWidget(findTable);
     filterLayout->addStretch();
 
     // Connect signals
@@ -1085,6 +1745,7 @@ void Home::setupFilters()
             this, &Home::onFilterChanged);
     connect(capacityFilter, QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, &Home::onFilterChanged);
+    connect(findTable, &QPushButton::clicked, this, &Home::assignTableForParty);
 }
 
 void Home::setupQuickStats()
@@ -1115,7 +1776,11 @@ void Home::setupQuickStats()
 
 void Home::showTableDetails(QPushButton* table)
 {
-    const TableInfo& info = tables[table->objectName()];
+    TableId tableId = tableIdFor(table);
+    if (!tables.contains(tableId))
+        return;
+
+    const TableInfo& info = tables[tableId];
 
     QDialog* details = new QDialog(this);
     details->setWindowTitle("Table Details");
@@ -1188,41 +1853,13 @@ void Home::showTableDetails(QPushButton* table)
 
 void Home::setupTableCapacityIndicators()
 {
-    QString tableStyle =
-        "QPushButton {"
-        "    background: qlineargradient(x1:0, y1:0, x2:0, y2:1,"
-        "                               stop:0 #FFFFFF, stop:1 #F5F5F5);"
-        "    color: #2C3E50;"
-        "    border: 2px solid #E0E0E0;"
-        "    border-radius: 12px;"
-        "    font-size: 14px;"
-        "    padding: 10px;"
-        "    text-align: center;"
-        "    min-height: 80px;"
-        "}"
-        "QPushButton:hover {"
-        "    border-color: #1B4965;"
-        "    background: qlineargradient(x1:0, y1:0, x2:0, y2:1,"
-        "                               stop:0 #F8F9FA, stop:1 #E9ECEF);"
-        "}"
-        "QPushButton[isVIP=\"true\"] {"
-        "    background: qlineargradient(x1:0, y1:0, x2:0, y2:1,"
-        "                               stop:0 #FFF8E1, stop:1 #FFF8DC);"
-        "    border: 2px solid #FFD700;"
-        "}"
-        "QPushButton QLabel {"
-        "    font-size: 12px;"
-        "    color: #666;"
-        "    margin-top: 4px;"
-        "}";
-
+    // Looks for each state (including the VIP border) live in kTableButtonStyle;
+    // FloorPlanRenderer sets the isVIP property when the table is first drawn
     for (int i = 1; i <= 14; i++) {
-        QString tableName = QString("Table%1").arg(i);
-        QPushButton *tableBtn = findChild<QPushButton *>(tableName);
+        int capacity = (i >= 13) ? 8 : 4;
+        TableId id = registerTable(QString("Table%1").arg(i), TableInfo(capacity));
+        QPushButton *tableBtn = tableButton(id);
         if (tableBtn) {
-            int capacity = (i >= 13) ? 8 : 4;
-            tables[tableName] = TableInfo(capacity);
-
             // Create a more detailed table display
             QString displayText = QString("Table %1\n%2 seats\n%3")
                                       .arg(i)
@@ -1230,13 +1867,6 @@ void Home::setupTableCapacityIndicators()
                                       .arg(capacity >= 8 ? "VIP" : "Standard");
 
             tableBtn->setText(displayText);
-            tableBtn->setStyleSheet(tableStyle);
-
-            if (capacity >= 8) {
-                tableBtn->setProperty("isVIP", true);
-                tableBtn->style()->unpolish(tableBtn);
-                tableBtn->style()->polish(tableBtn);
-            }
         }
     }
 }
@@ -1250,24 +1880,28 @@ void Home::onFilterChanged()
     QString selectedTimeRange = timeFilter->currentText();
     QString selectedCapacity = capacityFilter->currentText();
 
-    for (const auto &tableName : tables.keys()) {
-        QPushButton *tableButton = findChild<QPushButton *>(tableName);
-        if (!tableButton)
-            continue;
+    // Resolve the capacity filter for every table in one catalog pass
+    int minSeats = 0;
+    int maxSeats = INT_MAX;
+    if (selectedCapacity == "2-4 Guests") {
+        maxSeats = 4;
+    } else if (selectedCapacity == "5-8 Guests") {
+        minSeats = 5;
+        maxSeats = 8;
+    } else if (selectedCapacity == "8+ Guests") {
+        minSeats = 8;
+    }
+    std::vector<bool> capacityMatch(engine.tableCount(), false);
+    for (TableId id : engine.tablesWithSeats(minSeats, maxSeats)) {
+        capacityMatch[id] = true;
+    }
 
-        const TableInfo &info = tables[tableName];
-        bool showTable = true;
+    filteredOut.fill(false, tables.size());
+    for (TableId id = 0; id < tables.size(); ++id) {
+        const TableInfo &info = tables[id];
 
         // Apply capacity filter
-        if (selectedCapacity != "Any Capacity") {
-            if (selectedCapacity == "2-4 Guests" && info.seats > 4) {
-                showTable = false;
-            } else if (selectedCapacity == "5-8 Guests" && (info.seats < 5 || info.seats > 8)) {
-                showTable = false;
-            } else if (selectedCapacity == "8+ Guests" && info.seats < 8) {
-                showTable = false;
-            }
-        }
+        bool showTable = id < static_cast<int>(capacityMatch.size()) && capacityMatch[id];
 
         // Apply time filter for reserved tables
         if (showTable && selectedTimeRange != "All Times" && info.isReserved) {
@@ -1284,12 +1918,11 @@ void Home::onFilterChanged()
             }
         }
 
-        // Update table visibility
-        tableButton->setVisible(showTable);
-        if (showTable) {
-            updateTableAppearance(tableButton);
-        }
+        filteredOut[id] = !showTable;
     }
+
+    // Visibility is part of the rendered state, so only changed tables are touched
+    refreshTableAppearances();
 }
 
 void Home::setupReservationsPage()
@@ -1420,16 +2053,23 @@ void Home::setupReservationsPage()
         "color: #1B4965;");
     mainLayout->addWidget(upcomingLabel);
 
-    // Scrollable Reservations Area
-    QScrollArea* scrollArea = new QScrollArea(reservationsPage);
-    scrollArea->setWidgetResizable(true);
-    scrollArea->setStyleSheet("QScrollArea { border: none; background: transparent; }");
-
-    QWidget* scrollContent = new QWidget;
-    QVBoxLayout* reservationsLayout = new QVBoxLayout(scrollContent);
-    scrollArea->setWidget(scrollContent);
-
-    mainLayout->addWidget(scrollArea);
+    // Reservations list; rows are painted by the delegate and fetched lazily
+    reservationModel = new ReservationListModel(this);
+    ReservationCardDelegate* cardDelegate = new ReservationCardDelegate(this);
+    reservationList = new QListView(reservationsPage);
+    reservationList->setModel(reservationModel);
+    reservationList->setItemDelegate(cardDelegate);
+    reservationList->setUniformItemSizes(true);
+    reservationList->setMouseTracking(true);
+    reservationList->setSelectionMode(QAbstractItemView::NoSelection);
+    reservationList->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    reservationList->setStyleSheet("QListView { border: none; background: transparent; }");
+    connect(cardDelegate, &ReservationCardDelegate::cancelClicked,
+            this, &Home::cancelListedReservation);
+    connect(reservationModel, &ReservationListModel::fetchRequested,
+            this, &Home::requestReservationPage);
+
+    mainLayout->addWidget(reservationList);
 
     // Load initial reservations
     loadUserReservations();
@@ -1457,10 +2097,55 @@ void Home::setupBookingPage()
         button->setParent(bookingPage);
     }
 
+    setupFloorPlanView();
+
     // Initially hide the booking page
     bookingPage->hide();
 }
 
+// Spacing of the grid that places tables home.ui has no button for
+static const int kFloorPlanColumns = 6;
+static const int kFloorPlanCellWidth = 180;
+static const int kFloorPlanCellHeight = 120;
+
+void Home::setupFloorPlanView()
+{
+    // The buttons in home.ui cover the standard floor; venues with more
+    // tables switch to the graphics view, which scales to thousands
+    if (tables.size() <= totalTables)
+        return;
+
+    QRect area;
+    for (TableId id = 0; id < tables.size(); ++id) {
+        if (QPushButton *button = tableButton(id)) {
+            area |= button->geometry();
+            button->hide();
+        }
+    }
+
+    floorPlanView = new FloorPlanView(bookingPage);
+    floorPlanView->setGeometry(area.isEmpty() ? QRect(0, 80, 800, 640) : area);
+
+    // Tables keep their place on the standard floor; the rest follow in a grid below it
+    int extra = 0;
+    for (TableId id = 0; id < tables.size(); ++id) {
+        QPointF position;
+        if (QPushButton *button = tableButton(id)) {
+            position = button->geometry().topLeft() - area.topLeft();
+        } else {
+            position = QPointF((extra % kFloorPlanColumns) * kFloorPlanCellWidth,
+                               area.height() + kFloorPlanCellHeight / 2 + (extra / kFloorPlanColumns) * kFloorPlanCellHeight);
+            ++extra;
+        }
+        floorPlanView->addTable(id, 0, position, QString("Table %1").arg(tables.name(id).mid(5)),
+                                tables[id].seats);
+    }
+
+    connect(floorPlanView, &FloorPlanView::tableClicked, this, &Home::selectTable);
+    refreshTableAppearances();
+    floorPlanView->zoomToFit();
+}
+
 void Home::setupContactPage()
 {
     contactPage = new QWidget(this);
@@ -1739,14 +2424,9 @@ void Home::showReservationsPage()
         }
 
         // Reset selected table
-        if (selectedTable) {
-            selectedTable = nullptr;
-            for (const auto &tableName : tables.keys()) {
-                QPushButton *tableButton = findChild<QPushButton *>(tableName);
-                if (tableButton) {
-                    updateTableAppearance(tableButton);
-                }
-            }
+        if (selectedTable >= 0) {
+            selectedTable = -1;
+            refreshTableAppearances();
         }
 
         // Hide legend items
@@ -1776,14 +2456,9 @@ void Home::showBookingPage()
         }
 
         // Reset selected table
-        if (selectedTable) {
-            selectedTable = nullptr;
-            for (const auto &tableName : tables.keys()) {
-                QPushButton *tableButton = findChild<QPushButton *>(tableName);
-                if (tableButton) {
-                    updateTableAppearance(tableButton);
-                }
-            }
+        if (selectedTable >= 0) {
+            selectedTable = -1;
+            refreshTableAppearances();
         }
 
         // Show legend items
@@ -1898,39 +2573,33 @@ void Home::updateWalkinInfo()
     int small_table = 0;
     int big_table = 0;
 
-    // store table IDs of active tables in list
-    QList<QString> activeTables;
-
-    // Check each table for active reservations
-    for (const auto& tableId : tables.keys()) {
-        std::cout << "in get loop" << small_table << std::endl;
-        const TableInfo& tableInfo = tables[tableId];
-        for (const QDateTime& reservationTime : tableInfo.reservedTimes) {
-            // Check if the current time is within 1 hour of the start of the reservation
-            if (reservationTime <= currentDateTime && reservationTime.addSecs(3600) > currentDateTime) {
-                activeTables.append(tableId);
-                break; //
+    // Small tables seat up to 4, big tables more than that
+    const int smallSeats = 4;
+    int smallTotal = static_cast<int>(engine.tablesWithSeats(0, smallSeats).size());
+    int bigTotal = static_cast<int>(engine.tablesWithSeats(smallSeats + 1, INT_MAX).size());
+
+    EpochSeconds now = toEpoch(currentDateTime);
+    int day = engine.dayIndex(now);
+    int slot = engine.slotIndex(now);
+    if (slot >= 0) {
+        // Bookings cover their whole sitting in the grid, so a table is
+        // occupied exactly when the current slot is busy
+        small_table = smallTotal - static_cast<int>(engine.findFreeTables(day, slot, slot + 1, 0, smallSeats).size());
+        big_table = bigTotal - static_cast<int>(engine.findFreeTables(day, slot, slot + 1, smallSeats + 1).size());
+    } else {
+        // Outside the booking grid, ask each table's interval tree directly
+        for (TableId id = 0; id < tables.size(); ++id) {
+            if (engine.overlapping(id, now, now + 1).empty())
+                continue;
+            if (tables[id].seats <= smallSeats) {
+                small_table++;
+            } else {
+                big_table++;
             }
         }
     }
 
-    std::cout << "Active Tables Count: " << activeTables.size() << std::endl;
-    for (const QString& tableId : activeTables) {
-        std::cout << "Active Table ID:" << tableId.toStdString() << std::endl;
-    }
-
-    // count number of big vs small active tables
-    for (const QString& tableId : activeTables) {
-        //std::cout << "in count loop " << small_table << std::endl;
-        const TableInfo& tableInfo = tables[tableId];
-        if (tableInfo.seats == 4) {
-            std::cout << "small counted: " << small_table << std::endl;
-            small_table++;
-        } else if (tableInfo.seats == 8) {
-            std::cout << "big counted: " << big_table << std::endl;
-            big_table++;
-        }
-    }
+    std::cout << "Active Tables Count: " << small_table + big_table << std::endl;
 
     numTables = 14;
 
@@ -1972,14 +2641,10 @@ void Home::updateWalkinInfo()
 int Home::calculateActiveReservations()
 {
     int count = 0;
-    QDateTime currentDateTime = QDateTime::currentDateTime();
+    EpochSeconds now = toEpoch(QDateTime::currentDateTime());
 
-    for (const auto& tableInfo : tables) {
-        for (const QDateTime& reservationTime : tableInfo.reservedTimes) {
-            if (reservationTime > currentDateTime) {
-                count++;
-            }
-        }
+    for (TableId id = 0; id < tables.size(); ++id) {
+        count += engine.countStarts(id, now + 1, std::numeric_limits<EpochSeconds>::max());
     }
     return count;
 }
@@ -1989,151 +2654,112 @@ int Home::calculateActiveReservations()
 
 
 
-void Home::loadUserReservations(const ReservationFilter& filter)
+void Home::loadUserReservations()
 {
-    QScrollArea* scrollArea = reservationsPage->findChild<QScrollArea*>();
-    if (!scrollArea || !scrollArea->widget()) return;
-
-    QVBoxLayout* listLayout = qobject_cast<QVBoxLayout*>(scrollArea->widget()->layout());
-    if (!listLayout) return;
-
-    // Clear existing items
-    QLayoutItem* item;
-    while ((item = listLayout->takeAt(0)) != nullptr) {
-        delete item->widget();
-        delete item;
+    if (!reservationModel) return;
+
+    // Fetch reservations from the database specific to the current user. All
+    // filters are in the SQL, which runs on the search thread one page at a
+    // time; pages land in onReservationPage.
+    ReservationQuery query = reservationQuery;
+    query.ascending(m_sortAscending);
+    if (m_userMode == "customer") {
+        query.forUser(currentUser);
     }
 
-    // Fetch reservations from the database specific to the current user
-    QSqlDatabase logindb = QSqlDatabase::database();
-    QSqlQuery query(logindb);
-    if(m_userMode == "customer")
-    {
-        query.prepare("SELECT table_id, reservation_time FROM reservations WHERE username = :username");
-        query.bindValue(":username", currentUser);
-    }
-    else if(m_userMode == "manager")
-    {
-        query.prepare("SELECT table_id, reservation_time FROM reservations");
-    }
+    const quint64 generation = ++searchGeneration;
+    searchWorker->supersede(generation);
+    reservationModel->reset();
+    QMetaObject::invokeMethod(searchWorker, [worker = searchWorker, generation, query]() {
+        worker->start(generation, query);
+    }, Qt::QueuedConnection);
+}
 
-    if (!query.exec()) {
-        qDebug() << "Failed to load reservations for user:" << query.lastError().text();
-        return;
-    }
+void Home::requestReservationPage()
+{
+    const quint64 generation = searchGeneration;
+    QMetaObject::invokeMethod(searchWorker, [worker = searchWorker, generation]() {
+        worker->fetchMore(generation);
+    }, Qt::QueuedConnection);
+}
 
-    // Create reservation cards for the current user
-    while (query.next()) {
-        QString tableId = query.value("table_id").toString();
-        QDateTime reservationTime = QDateTime::fromString(query.value("reservation_time").toString(), Qt::ISODate);
+void Home::onReservationPage(quint64 generation, const QVector<ReservationHit> &hits, bool more)
+{
+    // Results of a search the user has already typed past
+    if (generation != searchGeneration) return;
 
+    QVector<ReservationRow> rows;
+    rows.reserve(hits.size());
+    for (const ReservationHit &hit : hits) {
         // Ensure that table info exists for the tableId
-        if (!tables.contains(tableId)) continue;  // If the table doesn't exist, skip
-
-        const TableInfo& info = tables[tableId];
-
-        // Apply the filter function here, passing the TableInfo and reservationTime
-        if (!filter(info, reservationTime)) continue;  // Apply filter if any
-
-        QWidget* card = new QWidget;
-        card->setStyleSheet(
-            "QWidget {"
-            "    background-color: white;"
-            "    border: 1px solid #E0E0E0;"
-            "    border-radius: 8px;"
-            "    padding: 16px;"
-            "}");
-
-        QHBoxLayout* cardLayout = new QHBoxLayout(card);
-
-        // Table Number
-        QLabel* tableNum = new QLabel(QString("Table %1").arg(tableId.mid(5)));
-        tableNum->setStyleSheet(
-            "font-weight: bold;"
-            "min-width: 80px;"
-            "color: #1B4965;");
-
-        // Time and Date
-        QVBoxLayout* timeLayout = new QVBoxLayout;
-        QLabel* dateLabel = new QLabel(reservationTime.toString("MMM d, yyyy"));
-        QLabel* timeLabel = new QLabel(reservationTime.toString("h:mm AP"));
-        dateLabel->setStyleSheet("color: #2C3E50;");
-        timeLabel->setStyleSheet("color: #6C757D;");
-        timeLayout->addWidget(dateLabel);
-        timeLayout->addWidget(timeLabel);
-
-        // Status
-        QLabel* statusLabel = new QLabel(info.isVIP ? "VIP" : "Standard");
-        statusLabel->setStyleSheet(info.isVIP ?
-                                       "color: #FFB400; font-weight: bold;" :
-                                       "color: #6C757D;");
-
-        // Cancel Button
-        QPushButton* cancelBtn = new QPushButton("Cancel");
-        cancelBtn->setStyleSheet(
-            "QPushButton {"
-            "    background-color: #DC3545;"
-            "    color: white;"
-            "    border-radius: 4px;"
-            "    padding: 8px 16px;"
-            "    border: none;"
-            "} "
-            "QPushButton:hover {"
-            "    background-color: #C82333;"
-            "}");
+        TableId id = tables.id(hit.tableId);
+        if (!tables.contains(id)) continue;  // If the table doesn't exist, skip
+
+        ReservationRow row;
+        row.table = id;
+        row.tableName = hit.tableId;
+        row.time = fromEpoch(hit.time);
+        row.isVIP = tables[id].isVIP;
+        rows.append(row);
+    }
 
-        cancelBtn->setFixedWidth(100);
+    reservationModel->appendRows(rows, more);
 
-        // Layout assembly
-        cardLayout->addWidget(tableNum);
-        cardLayout->addLayout(timeLayout);
-        cardLayout->addWidget(statusLabel);
-        cardLayout->addStretch();
-        cardLayout->addWidget(cancelBtn);
+    // Nothing visible came back, so the view has no reason to ask again
+    if (rows.isEmpty() && more) {
+        reservationModel->fetchMore(QModelIndex());
+    }
+}
 
-        listLayout->addWidget(card);
+void Home::cancelListedReservation(const QModelIndex &index)
+{
+    if (!index.isValid()) return;
 
-        // Connect cancel button
-        connect(cancelBtn, &QPushButton::clicked, this, [this, tableId, reservationTime]() {
-            // Remove reservation from the database
-            if (!removeReservationFromDatabase(tableId, reservationTime, currentUser)) {
-                QMessageBox::warning(this, "Database Error", "Failed to cancel reservation.");
-                return;
-            }
+    const ReservationRow row = reservationModel->row(index.row());
+    const QPersistentModelIndex listed(index);
 
-            // Remove from local reservation list
-            TableInfo& tableInfo = tables[tableId];
-            tableInfo.reservedTimes.removeOne(reservationTime);
-            saveReservations();
-            loadUserReservations();  // Refresh the list
-        });
-    }
+    // Remove reservation from the database, batched with other writes
+    removeReservationFromDatabase(row.tableName, row.time, currentUser, [this, row, listed](bool ok) {
+        if (!ok) {
+            QMessageBox::warning(this, "Database Error", "Failed to cancel reservation.");
+            return;
+        }
 
-    // Add stretch at the end
-    listLayout->addStretch();
+        // Remove from local reservation list and drop just this row from the view
+        engine.cancel(row.table, toEpoch(row.time));
+        journalReservation(ReservationJournal::Cancel, row.table, row.time);
+        bookingCalendar->refresh();
+        if (!listed.isValid()) return;  // The list was reloaded meanwhile
+
+        reservationModel->removeReservation(listed.row());
+        const quint64 generation = searchGeneration;
+        QMetaObject::invokeMethod(searchWorker, [worker = searchWorker, generation]() {
+            worker->rowRemoved(generation);
+        }, Qt::QueuedConnection);
+    });
 }
 
 
 
 
-bool Home::removeReservationFromDatabase(const QString &tableId, const QDateTime &reservationTime, const QString &username)
+void Home::removeReservationFromDatabase(const QString &tableId, const QDateTime &reservationTime, const QString &username,
+                                         const std::function<void(bool)> &done)
 {
-    // Ensure database connection
-    QSqlDatabase logindb = QSqlDatabase::database();
-
-    // Prepare and execute the SQL query
-    QSqlQuery query(logindb);
-    query.prepare("DELETE FROM reservations WHERE table_id = :table_id AND reservation_time = :reservation_time");
-    query.bindValue(":table_id", tableId);
-    query.bindValue(":reservation_time", reservationTime.toString(Qt::ISODate));
-    query.bindValue(":username", username);
-
-    if (!query.exec()) {
-        qDebug() << "Failed to remove reservation:" << query.lastError().text();
-        return false;
-    }
-
-    return true;
+    const qint64 time = toEpoch(reservationTime);
+    writeQueue->enqueue([tableId, time, username]() {
+        // Prepared once per connection, rebound per cancel
+        QSqlQuery &query = StatementCache::statement(
+            "DELETE FROM reservations WHERE table_id = :table_id AND reservation_time = :reservation_time");
+        query.bindValue(":table_id", tableId);
+        query.bindValue(":reservation_time", time);
+        query.bindValue(":username", username);
+
+        if (!query.exec()) {
+            qDebug() << "Failed to remove reservation:" << query.lastError().text();
+            return false;
+        }
+        return true;
+    }, done);
 }
 
 
@@ -2149,18 +2775,7 @@ void Home::on_Dashboard_clicked()
     showReservationsPage();
 
     // Update the statistics and reservations list
-    QScrollArea* scrollArea = reservationsPage->findChild<QScrollArea*>();
-    if (scrollArea && scrollArea->widget()) {
-        QVBoxLayout* listLayout = qobject_cast<QVBoxLayout*>(scrollArea->widget()->layout());
-        if (listLayout) {
-            // Clear and reload reservations
-            while (QLayoutItem* item = listLayout->takeAt(0)) {
-                delete item->widget();
-                delete item;
-            }
-            loadUserReservations();
-        }
-    }
+    loadUserReservations();
 
     // Update any statistics display
     QList<QLabel*> statLabels = reservationsPage->findChildren<QLabel*>();
@@ -2209,14 +2824,9 @@ void Home::cleanupNavigation()
     }
 
     // Reset selected table
-    if (selectedTable) {
-        selectedTable = nullptr;
-        for (const auto &tableName : tables.keys()) {
-            QPushButton *tableButton = findChild<QPushButton *>(tableName);
-            if (tableButton) {
-                updateTableAppearance(tableButton);
-            }
-        }
+    if (selectedTable >= 0) {
+        selectedTable = -1;
+        refreshTableAppearances();
     }
 }
 
@@ -2314,13 +2924,20 @@ void Home::setupReservationControls()
     }
 
     // Connect signals
-    connect(reservationSearchBox, &QLineEdit::textChanged, this, &Home::filterReservations);
+    // Filter changes are debounced so a burst of keystrokes runs one search
+    QTimer* searchDebounce = new QTimer(this);
+    searchDebounce->setSingleShot(true);
+    searchDebounce->setInterval(kSearchDebounceMs);
+    connect(searchDebounce, &QTimer::timeout, this, &Home::filterReservations);
+
+    auto restartDebounce = [searchDebounce]() { searchDebounce->start(); };
+    connect(reservationSearchBox, &QLineEdit::textChanged, searchDebounce, restartDebounce);
     connect(reservationStatusFilter, QOverload<int>::of(&QComboBox::currentIndexChanged),
-            this, &Home::filterReservations);
+            searchDebounce, restartDebounce);
     connect(reservationDateFilter, QOverload<int>::of(&QComboBox::currentIndexChanged),
-            this, &Home::filterReservations);
+            searchDebounce, restartDebounce);
     connect(reservationTypeFilter, QOverload<int>::of(&QComboBox::currentIndexChanged),
-            this, &Home::filterReservations);
+            searchDebounce, restartDebounce);
     connect(sortButton, &QPushButton::clicked, this, &Home::toggleReservationSort);
 }
 void Home::filterReservations()
@@ -2331,39 +2948,46 @@ void Home::filterReservations()
     QString type = reservationTypeFilter->currentText();
 
     QDateTime currentDateTime = QDateTime::currentDateTime();
+    QDate today = currentDateTime.date();
+    ReservationQuery query;
+
+    // Status filter
+    const EpochSeconds now = toEpoch(currentDateTime);
+    if (status == "Upcoming") query.between(now, std::numeric_limits<EpochSeconds>::max());
+    if (status == "Completed") query.between(std::numeric_limits<EpochSeconds>::min(), now + 1);
+
+    // Date range filter
+    if (dateRange == "Today") {
+        query.between(toEpoch(today.startOfDay()), toEpoch(today.addDays(1).startOfDay()));
+    } else if (dateRange == "This Week") {
+        query.between(toEpoch(today.startOfDay()), toEpoch(today.addDays(8).startOfDay()));
+    } else if (dateRange == "This Month") {
+        QDate first(today.year(), today.month(), 1);
+        query.between(toEpoch(first.startOfDay()), toEpoch(first.addMonths(1).startOfDay()));
+    }
 
-    loadUserReservations([=](const TableInfo& info, const QDateTime& reservationTime) -> bool {
-        // Search text filter
-        if (!searchText.isEmpty()) {
-            QString tableStr = QString("Table %1").arg(info.seats);
-            if (!tableStr.toLower().contains(searchText) &&
-                !info.customerName.toLower().contains(searchText)) {
-                return false;
+    // Search text and type depend on table details that live in the
+    // TableStore, so they are resolved to a table_id list here
+    if (!searchText.isEmpty() || type == "Standard" || type == "VIP") {
+        QStringList matching;
+        for (TableId id = 0; id < tables.size(); ++id) {
+            const TableInfo &info = tables[id];
+            if (!searchText.isEmpty()) {
+                QString tableStr = QString("Table %1").arg(info.seats);
+                if (!tableStr.toLower().contains(searchText) &&
+                    !info.customerName.toLower().contains(searchText)) {
+                    continue;
+                }
             }
+            if (type == "Standard" && info.isVIP) continue;
+            if (type == "VIP" && !info.isVIP) continue;
+            matching << tables.name(id);
         }
+        query.onTables(matching);
+    }
 
-        // Status filter
-        if (status == "Upcoming" && reservationTime < currentDateTime) return false;
-        if (status == "Completed" && reservationTime > currentDateTime) return false;
-
-        // Date range filter
-        if (dateRange == "Today" && reservationTime.date() != currentDateTime.date()) return false;
-        if (dateRange == "This Week") {
-            int daysTo = currentDateTime.date().daysTo(reservationTime.date());
-            if (daysTo < 0 || daysTo > 7) return false;
-        }
-        if (dateRange == "This Month" &&
-            (reservationTime.date().month() != currentDateTime.date().month() ||
-             reservationTime.date().year() != currentDateTime.date().year())) {
-            return false;
-        }
-
-        // Type filter
-        if (type == "Standard Tables" && info.isVIP) return false;
-        if (type == "VIP Tables" && !info.isVIP) return false;
-
-        return true;
-    });
+    reservationQuery = query;
+    loadUserReservations();
 }
 
 
@@ -2385,11 +3009,21 @@ void Home::exportReservations()
 {
     QString fileName = QFileDialog::getSaveFileName(this,
                                                     "Export Reservations", "",
-                                                    "CSV Files (*.csv);;All Files (*)");
+                                                    "CSV Files (*.csv);;JSON Files (*.json);;All Files (*)");
 
     if (fileName.isEmpty())
         return;
 
+    // JSON is the interchange format read back by importReservationsJson
+    if (fileName.endsWith(".json", Qt::CaseInsensitive)) {
+        if (exportReservationsJson(fileName)) {
+            QMessageBox::information(this, "Export Complete", "Reservations have been exported successfully.");
+        } else {
+            QMessageBox::warning(this, "Export Failed", "Could not write " + fileName + ".");
+        }
+        return;
+    }
+
     QFile file(fileName);
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
         return;
@@ -2399,12 +3033,13 @@ void Home::exportReservations()
 
     QDateTime currentDateTime = QDateTime::currentDateTime();
 
-    for (auto it = tables.begin(); it != tables.end(); ++it) {
-        const TableInfo& info = it.value();
-        for (const QDateTime& reservationTime : info.reservedTimes) {
+    for (TableId id = 0; id < tables.size(); ++id) {
+        const TableInfo& info = tables[id];
+        for (const auto &slot : engine.reservations(id)) {
+            QDateTime reservationTime = fromEpoch(slot.first);
             QString status = reservationTime > currentDateTime ? "Upcoming" : "Completed";
             out << QString("%1,%2,%3,%4,%5,%6\n")
-                       .arg(it.key())
+                       .arg(tables.name(id))
                        .arg(reservationTime.date().toString("yyyy-MM-dd"))
                        .arg(reservationTime.time().toString("HH:mm"))
                        .arg(info.isVIP ? "VIP" : "Standard")
@@ -2421,13 +3056,12 @@ int Home::calculateDailyRevenue()
 {
     int revenue = 0;
     QDate today = QDate::currentDate();
+    EpochSeconds dayStart = toEpoch(today.startOfDay());
+    EpochSeconds dayEnd = toEpoch(today.addDays(1).startOfDay());
 
-    for (const auto& tableInfo : tables) {
-        for (const QDateTime& reservationTime : tableInfo.reservedTimes) {
-            if (reservationTime.date() == today) {
-                revenue += tableInfo.isVIP ? 200 : 100;  // VIP tables cost more
-            }
-        }
+    for (TableId id = 0; id < tables.size(); ++id) {
+        int reservedToday = engine.countStarts(id, dayStart, dayEnd);
+        revenue += reservedToday * (tables[id].isVIP ? 200 : 100);  // VIP tables cost more
     }
     return revenue;
 }
@@ -2436,14 +3070,12 @@ int Home::countVIPReservations()
 {
     int count = 0;
     QDate today = QDate::currentDate();
+    EpochSeconds dayStart = toEpoch(today.startOfDay());
+    EpochSeconds dayEnd = toEpoch(today.addDays(1).startOfDay());
 
-    for (const auto& tableInfo : tables) {
-        if (tableInfo.isVIP) {
-            for (const QDateTime& reservationTime : tableInfo.reservedTimes) {
-                if (reservationTime.date() == today) {
-                    count++;
-                }
-            }
+    for (TableId id = 0; id < tables.size(); ++id) {
+        if (tables[id].isVIP) {
+            count += engine.countStarts(id, dayStart, dayEnd);
         }
     }
     return count;
@@ -2451,5 +3083,12 @@ int Home::countVIPReservations()
 
 Home::~Home()
 {
+    // Land queued bookings while their callbacks can still run
+    writeQueue->flush();
+
+    // Stop the search thread before its connection's parent goes away
+    searchWorker->supersede(++searchGeneration);
+    searchThread->quit();
+    searchThread->wait();
     delete ui;
 }
@@ -4,11 +4,14 @@
 #include <QDateTime>
 #include <QDialog>
 #include <QMap>
+#include <QPointer>
 #include <QPushButton>
 #include <QLabel>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QComboBox>
+#include <QDateEdit>
+#include <QSpinBox>
 #include <QWidget>
 #include <QStyle>
 #include <QTextEdit>
@@ -20,31 +23,29 @@
 #include <QTextStream>
 #include <functional>
 #include <QClipboard>
+#include <QJsonObject>
+
+#include <QListView>
+#include <QThread>
+
+#include "floorplanrenderer.h"
+#include "floorplanview.h"
+#include "occupancycalendar.h"
+#include "reservationengine.h"
+#include "reservationjournal.h"
+#include "reservationlistmodel.h"
+#include "reservationquery.h"
+#include "reservationsearchworker.h"
+#include "reservationsnapshot.h"
+#include "reseatingsolver.h"
+#include "reservationwritequeue.h"
+#include "tableassigner.h"
+#include "tablestore.h"
 
 namespace Ui {
 class Home;
 }
 
-class TableInfo
-{
-public:
-    int seats;
-    bool isReserved;
-    QDateTime reservationTime;
-    QString customerName;
-    QList<QDateTime> reservedTimes;
-    bool isVIP;
-    QString specialNotes;
-    double minSpend;
-
-    TableInfo(int s = 4)
-        : seats(s)
-        , isReserved(false)
-        , isVIP(s >= 8)
-        , minSpend(0.0)
-    {}
-};
-
 class Home : public QDialog
 {
     Q_OBJECT
@@ -61,8 +62,24 @@ private:
 
 public:
      Home(QWidget *parent = nullptr, const QString &userMode = "", int userId = 0, const QString &username = "");
-    bool saveReservationToDatabase(const QString &tableId, const QDateTime &reservationTime, const QString &username);
-     bool removeReservationFromDatabase(const QString &tableId, const QDateTime &reservationTime, const QString &username);
+    // One table of a booking and how long the booking holds it
+    struct TableBooking
+    {
+        QString tableId;
+        EpochSeconds length;
+    };
+
+    // Queued on the group-commit writer as one job, so a party on joined
+    // tables gets every table or none; `done` runs once the batch commits.
+    // When a booking within `length` already holds one of the tables in the
+    // database, `saved` is false and `conflictTable` and `conflictingSlot`
+    // name that booking.
+    void saveReservationToDatabase(const QVector<TableBooking> &bookings, const QDateTime &reservationTime,
+                                   const QString &username,
+                                   const std::function<void(bool saved, const QString &conflictTable,
+                                                            const QDateTime &conflictingSlot)> &done);
+    void removeReservationFromDatabase(const QString &tableId, const QDateTime &reservationTime, const QString &username,
+                                       const std::function<void(bool)> &done);
 
     ~Home() override;
 
@@ -85,16 +102,31 @@ private slots:
     void on_Locations_clicked();
     void on_Table1_list_currentTextChanged(const QString &text);
     void onFilterChanged();  // New slot for filter changes
+    void cancelListedReservation(const QModelIndex &index);
+    void requestReservationPage();
+    void onReservationPage(quint64 generation, const QVector<ReservationHit> &hits, bool more);
+    void assignTableForParty();
 
 private:
-    // Define the function types for reservation filtering and sorting
-    using ReservationFilter = std::function<bool(const TableInfo&, const QDateTime&)>;
+    // Cached floor plan button for a table, resolved on first use
+    struct TableButtonHandle
+    {
+        QPointer<QPushButton> button;
+        bool resolved = false;
+    };
 
     // Member variables
     Ui::Home *ui;
     QString m_userMode;
-    QMap<QString, TableInfo> tables;
-    QPushButton *selectedTable;
+    TableStore tables;         // Indexed by TableId, shared with the engine
+    ReservationEngine engine;  // Owns every reserved time, indexed per table
+    TableAssigner assigner{engine};  // Seats a party of a given size automatically
+    ReseatingSolver reseater{engine};  // Re-plans a day when tables or parties change
+    QVector<TableButtonHandle> tableButtons;  // Indexed by TableId
+    QVector<bool> filteredOut;                // Hidden by the capacity/time filters
+    FloorPlanRenderer floorRenderer;
+    FloorPlanView *floorPlanView = nullptr;   // Replaces the buttons on large floors
+    TableId selectedTable;                    // -1 when no table is selected
     bool m_sortAscending;
 
     // UI elements
@@ -110,6 +142,17 @@ private:
     QComboBox* reservationTypeFilter;
     QComboBox* timeFilter;
     QComboBox* capacityFilter;
+    QSpinBox* partySize = nullptr;
+    QDateEdit* bookingDate = nullptr;               // Day the time slots are offered for
+    OccupancyCalendar* bookingCalendar = nullptr;   // bookingDate's popup
+    QListView* reservationList;
+    ReservationListModel* reservationModel;
+    ReservationQuery reservationQuery;  // Filters chosen on the dashboard
+    QThread* searchThread;
+    ReservationSearchWorker* searchWorker;
+    quint64 searchGeneration = 0;  // Bumped by every search; older pages are dropped
+    ReservationJournal* journal;  // Changes since the reservations.json snapshot
+    ReservationWriteQueue* writeQueue;  // Group-commits database inserts and deletes
     QWidget* contactPage;
     QWidget* walkinPage;
 
@@ -125,11 +168,39 @@ private:
     void setupTables();
     void setupConnections();
     void resetTableStyles();
-    void updateTableAppearance(QPushButton *table);
-    void showReservationPrompt(QPushButton *table);
+    void updateTableAppearance(TableId id);
+    void stageTableAppearance(TableId id, bool isReservedAtSelectedTime);
+    void refreshTableAppearances();
+    bool selectedSlot(int &day, int &slot) const;
+    void showReservationPrompt(TableId tableId);
+    void selectTable(TableId id);
+    void setupFloorPlanView();
+    void setupTableJoins();
+    // Claims every table in the engine for its sitting, then queues one
+    // database job for all of them; any refusal releases every claim
+    void bookTables(const std::vector<TableId> &tableIds, const QDateTime &reservationTime);
+    void setTableInService(TableId id, bool inService);
+    std::vector<TableId> outOfServiceTables() const;
+    QString describeMoves(const ReseatingSolver::Plan &plan) const;
+    // Moves the plan's bookings in the engine, then in the database as one
+    // job; `done` gets false, with everything put back, if either refuses
+    void applyReseating(const ReseatingSolver::Plan &plan, const std::function<void(bool)> &done);
+    void undoReseating(const std::vector<ReseatingSolver::Move> &moves,
+                       const std::vector<ReservationEngine::Interval> &originals, std::size_t placed);
+    void moveReservationsInDatabase(const std::vector<ReseatingSolver::Move> &moves,
+                                    const std::function<void(bool)> &done);
     void loadReservations();
+    bool importReservationsJson(const QString &path);
+    bool exportReservationsJson(const QString &path);
     void saveReservations();
+    void journalReservation(ReservationJournal::Op op, TableId id, const QDateTime &time);
+    void applyJournalRecord(const ReservationJournal::Record &record);
+    QJsonObject tableReservationsJson(TableId id) const;
     bool isTableAvailable(const QString &tableId, const QDateTime &requestedTime);
+    TableId registerTable(const QString &tableName, const TableInfo &info);
+    TableId tableIdFor(const QPushButton *table) const;
+    QPushButton *tableButton(TableId id);
+    void invalidateTableButtons();
     void populateTimeSlots();
     void resetTableStyle(QPushButton *table);
     void cleanupNavigation();
@@ -145,7 +216,7 @@ private:
     void filterReservations();
     void toggleReservationSort();
     void exportReservations();
-    void loadUserReservations(const ReservationFilter& filter = [](const TableInfo&, const QDateTime&) { return true; });
+    void loadUserReservations();
 
     // Page management
     void setupReservationsPage();
@@ -4,6 +4,8 @@
 #include "ui_loginscreen.h"
 #include "usersignup.h"
 #include "home.h"
+#include "reservationdatabase.h"
+#include "statementcache.h"
 #include <QPixmap>
 #include <QSqlDatabase>
 #include <QSqlQuery>
@@ -20,12 +22,13 @@ LoginScreen::LoginScreen(QWidget *parent)
 
     QSqlDatabase logindb = QSqlDatabase::addDatabase("QSQLITE");
     logindb.setDatabaseName("testdb.db");
-    logindb.open();
 
-    if (!logindb.open()) {
+    if (!ReservationDatabase::open(logindb, ConnectionProfile::fromSettings("testdb.ini"))) {
         qDebug() << "Error: Could not connect to database." << logindb.lastError().text();
     } else {
         qDebug() << "Database connected successfully!";
+        qDebug() << "Database settings:" << ReservationDatabase::describe(logindb);
+        ReservationDatabase::migrate(logindb);
     }
 }
 
@@ -44,14 +47,15 @@ void LoginScreen::on_pushButton_login_clicked() {
     QString password = hashPassword(ui->lineEdit_password->text());
 
     // Query the database for user credentials
-    QSqlQuery query;
-    query.prepare("SELECT permission, id FROM users WHERE username = :username AND password = :password");
+    QSqlQuery &query = StatementCache::statement(
+        "SELECT permission, id FROM users WHERE username = :username AND password = :password");
     query.bindValue(":username", username);
     query.bindValue(":password", password);
 
     if (query.exec() && query.next()) {
         QString permission = query.value(0).toString();
         int userId = query.value(1).toInt();
+        query.finish();  // The statement stays cached; release its read
 
         qDebug() << "Login successful!";
         qDebug() << "Permission:" << permission << ", User ID:" << userId << ", Username:" << username;
@@ -93,8 +97,8 @@ void LoginScreen::createAccount(QString Username, QString Password, QString Perm
 }
 
 bool LoginScreen::addUser(const QString &username, const QString &password, const QString &permission, const QString &number) {
-    QSqlQuery query;
-    query.prepare("INSERT INTO users (username, password, permission, number) VALUES (:username, :password, :permission, :number)");
+    QSqlQuery &query = StatementCache::statement(
+        "INSERT INTO users (username, password, permission, number) VALUES (:username, :password, :permission, :number)");
     query.bindValue(":username", username);
     query.bindValue(":password", password);
     query.bindValue(":permission", permission);
@@ -114,14 +118,12 @@ bool LoginScreen::addUser(const QString &username, const QString &password, cons
 }
 
 bool LoginScreen::checkUserCredentials(const QString &username, const QString &password) {
-    QSqlQuery query;
-    query.prepare("SELECT permission FROM users WHERE username = :username AND password = :password");
+    QSqlQuery &query = StatementCache::statement(
+        "SELECT permission FROM users WHERE username = :username AND password = :password");
     query.bindValue(":username", username);
     query.bindValue(":password", password);
 
-    if (query.exec() && query.next()) {
-        return true;
-    } else {
-        return false;
-    }
+    bool found = query.exec() && query.next();
+    query.finish();
+    return found;
 }
@@ -0,0 +1,87 @@
+#include "occupancycalendar.h"
+
+#include <QDateTime>
+#include <QPainter>
+
+static const int kStripHeight = 4;
+
+OccupancyCalendar::OccupancyCalendar(const ReservationEngine &engine, QWidget *parent)
+    : QCalendarWidget(parent)
+    , engine(engine)
+{
+    const QDate today = QDate::currentDate();
+    setDateRange(today, today.addDays(kDaysAhead));
+    setVerticalHeaderFormat(QCalendarWidget::NoVerticalHeader);
+    setGridVisible(false);
+}
+
+void OccupancyCalendar::setCapacityClass(int capacity)
+{
+    if (capacity >= OccupancySummary::kClassCount)
+        capacity = -1;
+    if (this->capacity == capacity)
+        return;
+
+    this->capacity = capacity;
+    updateCells();
+}
+
+void OccupancyCalendar::refresh()
+{
+    // Today moves forward while the dialog stays open
+    const QDate today = QDate::currentDate();
+    if (minimumDate() != today) {
+        setDateRange(today, today.addDays(kDaysAhead));
+    }
+    updateCells();
+}
+
+double OccupancyCalendar::occupancy(const QDate &date) const
+{
+    // Midday is inside the day on either side of a DST change
+    const int day = engine.dayIndex(QDateTime(date, QTime(12, 0)).toSecsSinceEpoch());
+    const OccupancySummary &summary = engine.occupancy();
+    if (!summary.hasBookings(day))
+        return 0.0;
+
+    const int first = capacity < 0 ? 0 : capacity;
+    const int last = capacity < 0 ? OccupancySummary::kClassCount : capacity + 1;
+    long busy = 0;
+    long total = 0;
+    for (int c = first; c < last; ++c) {
+        const auto capacityClass = OccupancySummary::CapacityClass(c);
+        for (int slot = 0; slot < SlotGrid::kSlotsPerDay; ++slot) {
+            busy += summary.busyCount(day, slot, capacityClass);
+        }
+        total += long(summary.tableCount(capacityClass)) * SlotGrid::kSlotsPerDay;
+    }
+    return total > 0 ? double(busy) / double(total) : 0.0;
+}
+
+void OccupancyCalendar::paintCell(QPainter *painter, const QRect &rect, QDate date) const
+{
+    QCalendarWidget::paintCell(painter, rect, date);
+    if (date < minimumDate() || date > maximumDate())
+        return;
+
+    const double booked = occupancy(date);
+    if (booked <= 0.0)
+        return;
+
+    // Green while most tables are free, through amber, to the Reserved red
+    QColor heat;
+    if (booked < 0.5) {
+        heat = QColor("#4CAF50");
+    } else if (booked < 0.85) {
+        heat = QColor("#FFB400");
+    } else {
+        heat = QColor("#FF4444");
+    }
+
+    painter->save();
+    QRect strip(rect.left() + 2, rect.bottom() - kStripHeight - 1, rect.width() - 4, kStripHeight);
+    painter->fillRect(strip, QColor("#E0E0E0"));
+    strip.setWidth(qMax(1, int(strip.width() * booked)));
+    painter->fillRect(strip, heat);
+    painter->restore();
+}
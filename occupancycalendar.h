@@ -0,0 +1,38 @@
+#ifndef OCCUPANCYCALENDAR_H
+#define OCCUPANCYCALENDAR_H
+
+#include <QCalendarWidget>
+
+#include "reservationengine.h"
+
+// Booking calendar for the next kDaysAhead days. Every date carries a heat
+// strip showing how booked that day is, read from the engine's
+// OccupancySummary: painting a month costs days x slots counter reads,
+// whatever the number of reservations.
+class OccupancyCalendar : public QCalendarWidget
+{
+    Q_OBJECT
+
+public:
+    static constexpr int kDaysAhead = 90;
+
+    explicit OccupancyCalendar(const ReservationEngine &engine, QWidget *parent = nullptr);
+
+    // Restricts the heat to one capacity class, or every table when negative
+    void setCapacityClass(int capacity);
+
+    // Repaints after reservations changed; the dates themselves are unchanged
+    void refresh();
+
+    // Share of table slots booked on `date`, 0 to 1
+    double occupancy(const QDate &date) const;
+
+protected:
+    void paintCell(QPainter *painter, const QRect &rect, QDate date) const override;
+
+private:
+    const ReservationEngine &engine;
+    int capacity = -1;
+};
+
+#endif // OCCUPANCYCALENDAR_H
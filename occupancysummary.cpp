@@ -0,0 +1,50 @@
+#include "occupancysummary.h"
+
+OccupancySummary::CapacityClass OccupancySummary::classFor(int seats)
+{
+    return seats <= 2 ? UpToTwo : seats <= 4 ? UpToFour : Larger;
+}
+
+void OccupancySummary::addTable(int seats)
+{
+    ++totals[classFor(seats)];
+}
+
+void OccupancySummary::removeTable(int seats)
+{
+    --totals[classFor(seats)];
+}
+
+void OccupancySummary::add(int day, int slot, int seats, int delta)
+{
+    if (slot < 0 || slot >= SlotGrid::kSlotsPerDay)
+        return;
+
+    auto it = days.find(day);
+    if (it == days.end()) {
+        if (delta <= 0)
+            return;
+        it = days.emplace(day, Counts{}).first;
+    }
+
+    it->second[slot * kClassCount + classFor(seats)] += delta;
+}
+
+void OccupancySummary::clear()
+{
+    days.clear();
+}
+
+int OccupancySummary::busyCount(int day, int slot, CapacityClass capacity) const
+{
+    if (slot < 0 || slot >= SlotGrid::kSlotsPerDay)
+        return 0;
+
+    auto it = days.find(day);
+    return it == days.end() ? 0 : it->second[slot * kClassCount + capacity];
+}
+
+int OccupancySummary::freeCount(int day, int slot, CapacityClass capacity) const
+{
+    return totals[capacity] - busyCount(day, slot, capacity);
+}
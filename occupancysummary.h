@@ -0,0 +1,46 @@
+#ifndef OCCUPANCYSUMMARY_H
+#define OCCUPANCYSUMMARY_H
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+
+#include "slotgrid.h"
+
+// Busy-table counts per day, slot and capacity class. ReservationEngine
+// updates it whenever a SlotGrid bit flips, so a calendar covering months
+// reads days x slots counters instead of walking individual reservations.
+// Capacity classes follow SittingPolicy: 2-tops, 4-tops and larger tables.
+class OccupancySummary
+{
+public:
+    enum CapacityClass {
+        UpToTwo,
+        UpToFour,
+        Larger,
+        kClassCount
+    };
+
+    static CapacityClass classFor(int seats);
+
+    // Table totals per class
+    void addTable(int seats);
+    void removeTable(int seats);
+    int tableCount(CapacityClass capacity) const { return totals[capacity]; }
+
+    // Busy counts, `delta` is +1 when a table becomes busy and -1 when it frees up
+    void add(int day, int slot, int seats, int delta);
+    void clear();
+
+    int busyCount(int day, int slot, CapacityClass capacity) const;
+    int freeCount(int day, int slot, CapacityClass capacity) const;
+    bool hasBookings(int day) const { return days.count(day) > 0; }
+
+private:
+    using Counts = std::array<std::int32_t, SlotGrid::kSlotsPerDay * kClassCount>;
+
+    std::array<int, kClassCount> totals{};
+    std::unordered_map<int, Counts> days;
+};
+
+#endif // OCCUPANCYSUMMARY_H
@@ -0,0 +1,583 @@
+#include "reseatingsolver.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <utility>
+
+namespace {
+
+struct Item
+{
+    EpochSeconds start;
+    EpochSeconds end;              // On its own table, or its party's sitting for an addition
+    TableId original;              // -1 for an addition
+    int minSeats;
+    std::vector<TableId> domain;   // Tables it may use, best fit first
+};
+
+struct Problem
+{
+    const ReservationEngine *engine;
+    std::vector<Item> items;
+    std::vector<TableId> initial;  // Starting table per item, -1 if displaced
+    std::vector<ReservationEngine::SlotIndex> fixed;  // Per table, bookings left alone
+    std::vector<char> inService;
+    std::vector<EpochSeconds> sitting;  // Per table
+    int mustMove = 0;              // Existing bookings on out of service tables
+    int maxDepth = 0;
+
+    // Only start times are stored, so a booking on another table is loaded
+    // back with that table's sitting; plan with the same length
+    EpochSeconds endOn(const Item &item, TableId table) const
+    {
+        return table == item.original ? item.end : item.start + sitting[table];
+    }
+};
+
+struct Shared
+{
+    int limit = INT_MAX;  // Most moves the current pass may spend
+    std::atomic<int> bestCost{INT_MAX};
+    std::atomic<bool> stop{false};
+    std::atomic<bool> timedOut{false};
+    std::atomic<long> nodes{0};
+    std::chrono::steady_clock::time_point deadline;
+    std::mutex lock;
+    std::vector<TableId> best;
+};
+
+struct Option
+{
+    TableId table;
+    std::vector<int> bumped;
+    int costDelta;
+};
+
+// One thread's view of a partial plan. Cost counts existing bookings that
+// are not on their own table, displaced ones included.
+class Search
+{
+public:
+    Search(const Problem &problem, Shared &shared)
+        : problem(problem)
+        , shared(shared)
+        , assignment(problem.initial)
+        , settled(problem.initial.size(), 0)
+        , occupancy(problem.fixed.size())
+        , cost(problem.mustMove)
+    {
+        for (std::size_t t = 0; t < problem.fixed.size(); ++t) {
+            for (const auto &booking : problem.fixed[t]) {
+                occupancy[t].emplace(booking.first, std::make_pair(booking.second, -1));
+            }
+        }
+        for (int i = 0; i < int(problem.items.size()); ++i) {
+            if (assignment[i] < 0) {
+                unassigned.push_back(i);
+            } else {
+                occupancy[assignment[i]].emplace(problem.items[i].start,
+                                                 std::make_pair(problem.endOn(problem.items[i], assignment[i]), i));
+            }
+        }
+    }
+
+    bool done() const { return unassigned.empty(); }
+
+    // Forward checking: the displaced booking with the fewest options, or
+    // an empty list when some booking has none left
+    std::vector<Option> choose(int &item) const
+    {
+        // Counting stops at the best count so far, so only the chosen
+        // booking pays for its full option list
+        item = -1;
+        std::size_t fewest = SIZE_MAX;
+        for (int candidate : unassigned) {
+            std::vector<Option> found;
+            collect(candidate, fewest, found);
+            if (found.size() < fewest) {
+                item = candidate;
+                fewest = found.size();
+                if (fewest == 0)
+                    return {};
+            }
+        }
+
+        std::vector<Option> result;
+        collect(item, SIZE_MAX, result);
+
+        // Cheapest first, then fewest bumps; ties keep the best fit order
+        std::stable_sort(result.begin(), result.end(), [](const Option &a, const Option &b) {
+            if (a.costDelta != b.costDelta)
+                return a.costDelta < b.costDelta;
+            return a.bumped.size() < b.bumped.size();
+        });
+        return result;
+    }
+
+    void apply(int item, const Option &option)
+    {
+        for (int bumped : option.bumped) {
+            unplace(bumped);
+        }
+        place(item, option.table);
+        settled[item] = 1;
+        cost += option.costDelta;
+    }
+
+    void undo(int item, const Option &option)
+    {
+        cost -= option.costDelta;
+        settled[item] = 0;
+        unplace(item);
+        for (auto it = option.bumped.rbegin(); it != option.bumped.rend(); ++it) {
+            place(*it, option.table);
+        }
+    }
+
+    void record()
+    {
+        // Placing the last booking adds its cost after the bound check, so
+        // a leaf can be one over the pass's budget; leave it to the next pass
+        if (cost > shared.limit || cost >= shared.bestCost.load())
+            return;
+
+        std::lock_guard<std::mutex> guard(shared.lock);
+        if (cost < shared.bestCost.load()) {
+            shared.bestCost = cost;
+            shared.best = assignment;
+        }
+        // Earlier passes found nothing cheaper
+        shared.stop = true;
+    }
+
+    void run(int depth)
+    {
+        if (shared.stop.load(std::memory_order_relaxed))
+            return;
+        if ((++nodes & 63) == 0 && std::chrono::steady_clock::now() > shared.deadline) {
+            shared.timedOut = true;
+            shared.stop = true;
+            return;
+        }
+
+        if (done()) {
+            record();
+            return;
+        }
+        const int bound = lowerBound();
+        if (depth >= problem.maxDepth || bound > shared.limit
+            || bound >= shared.bestCost.load(std::memory_order_relaxed))
+            return;
+
+        int item;
+        const std::vector<Option> found = choose(item);
+        for (const Option &option : found) {
+            apply(item, option);
+            run(depth + 1);
+            undo(item, option);
+            if (shared.stop.load(std::memory_order_relaxed))
+                return;
+        }
+    }
+
+    long nodeCount() const { return nodes; }
+
+private:
+    // Bookings that can still go back to their own table may cost nothing
+    int lowerBound() const
+    {
+        int bound = cost;
+        for (int item : unassigned) {
+            TableId original = problem.items[item].original;
+            if (original >= 0 && problem.inService[original])
+                --bound;
+        }
+        return bound;
+    }
+
+    // Up to `limit` ways to seat `item`, in domain order
+    void collect(int item, std::size_t limit, std::vector<Option> &result) const
+    {
+        const TableId original = problem.items[item].original;
+        for (TableId table : problem.items[item].domain) {
+            if (result.size() >= limit)
+                return;
+            const Item &booking = problem.items[item];
+            const auto &booked = occupancy[table];
+
+            Option option{table, {}, table == original && original >= 0 ? -1 : 0};
+            auto it = booked.lower_bound(booking.start);
+            if (it != booked.begin() && std::prev(it)->second.first > booking.start)
+                --it;
+
+            const EpochSeconds end = problem.endOn(booking, table);
+            bool blocked = false;
+            for (; it != booked.end() && it->first < end; ++it) {
+                // A booking is placed at most once per branch, so bumps never cycle
+                const int occupant = it->second.second;
+                if (occupant < 0 || settled[occupant] || int(option.bumped.size()) == ReseatingSolver::kMaxBumped) {
+                    blocked = true;
+                    break;
+                }
+                option.bumped.push_back(occupant);
+                if (problem.items[occupant].original == table)
+                    ++option.costDelta;
+            }
+            if (!blocked)
+                result.push_back(std::move(option));
+        }
+    }
+
+    void place(int item, TableId table)
+    {
+        const Item &booking = problem.items[item];
+        occupancy[table].emplace(booking.start, std::make_pair(problem.endOn(booking, table), item));
+        assignment[item] = table;
+        unassigned.erase(std::find(unassigned.begin(), unassigned.end(), item));
+    }
+
+    void unplace(int item)
+    {
+        occupancy[assignment[item]].erase(problem.items[item].start);
+        assignment[item] = -1;
+        unassigned.push_back(item);
+    }
+
+    const Problem &problem;
+    Shared &shared;
+    std::vector<TableId> assignment;
+    std::vector<char> settled;  // Placed on this branch, no longer bumpable
+    std::vector<std::map<EpochSeconds, std::pair<EpochSeconds, int>>> occupancy;  // start -> end, item
+    std::vector<int> unassigned;
+    int cost;
+    long nodes = 0;
+};
+
+std::vector<TableId> domainFor(const ReservationEngine &engine, const std::vector<char> &inService,
+                               int minSeats, bool vipOnly)
+{
+    const TableCatalog &catalog = engine.tables();
+    std::vector<TableId> domain;
+    for (TableId id : engine.tablesWithSeats(minSeats)) {
+        if (inService[id] && (!vipOnly || catalog.isVIP(id)))
+            domain.push_back(id);
+    }
+
+    // Best fit: fewest spare seats, and VIP tables last for regular bookings
+    std::stable_sort(domain.begin(), domain.end(), [&](TableId a, TableId b) {
+        int spareA = catalog.seats(a) - minSeats;
+        int spareB = catalog.seats(b) - minSeats;
+        if (spareA != spareB)
+            return spareA < spareB;
+        return !vipOnly && catalog.isVIP(a) < catalog.isVIP(b);
+    });
+    return domain;
+}
+
+// First plan, in start order: bookings keep their table when they can,
+// otherwise take the best fitting free table. Only if every table is taken
+// does a booking push out later ones, which are then re-seated in turn.
+// Returns the number of moved bookings, or INT_MAX if some booking found
+// no table.
+int greedy(const Problem &problem, std::vector<TableId> &assignment)
+{
+    const int count = static_cast<int>(problem.items.size());
+    std::vector<int> order(count);
+    for (int i = 0; i < count; ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return problem.items[a].start < problem.items[b].start;
+    });
+
+    assignment = problem.initial;
+    std::vector<std::map<EpochSeconds, std::pair<EpochSeconds, int>>> occupancy(problem.fixed.size());
+    for (std::size_t t = 0; t < problem.fixed.size(); ++t) {
+        for (const auto &booking : problem.fixed[t]) {
+            occupancy[t].emplace(booking.first, std::make_pair(booking.second, -1));
+        }
+    }
+    for (int i = 0; i < count; ++i) {
+        if (assignment[i] >= 0)
+            occupancy[assignment[i]].emplace(problem.items[i].start,
+                                             std::make_pair(problem.endOn(problem.items[i], assignment[i]), i));
+    }
+
+    std::vector<char> done(count, 0);
+    int moved = problem.mustMove;
+    for (int item : order) {
+        done[item] = 1;
+        if (assignment[item] >= 0)
+            continue;
+
+        const Item &booking = problem.items[item];
+        TableId chosen = -1;
+        std::vector<int> evicted;
+        for (TableId table : booking.domain) {
+            const auto &booked = occupancy[table];
+            auto it = booked.lower_bound(booking.start);
+            if (it != booked.begin() && std::prev(it)->second.first > booking.start)
+                --it;
+
+            const EpochSeconds end = problem.endOn(booking, table);
+            std::vector<int> blocking;
+            bool blocked = false;
+            for (; it != booked.end() && it->first < end; ++it) {
+                const int occupant = it->second.second;
+                if (occupant < 0 || done[occupant]) {
+                    blocked = true;
+                    break;
+                }
+                blocking.push_back(occupant);
+            }
+            if (blocked)
+                continue;
+            if (chosen < 0 || blocking.size() < evicted.size()) {
+                chosen = table;
+                evicted = std::move(blocking);
+                if (evicted.empty())
+                    break;
+            }
+        }
+        if (chosen < 0)
+            return INT_MAX;
+
+        for (int occupant : evicted) {
+            occupancy[assignment[occupant]].erase(problem.items[occupant].start);
+            assignment[occupant] = -1;
+            ++moved;  // Still on its own table until now
+        }
+        occupancy[chosen].emplace(booking.start, std::make_pair(problem.endOn(booking, chosen), item));
+        assignment[item] = chosen;
+        if (chosen == booking.original)
+            --moved;
+    }
+    return moved;
+}
+
+// Counting check before any search. Bookings that need k or more seats
+// (or a VIP table) can never be in progress in greater number than the
+// in-service tables offering that, for every k a displaced booking asks
+// for. Without it an impossible request would only end at the time limit.
+// Each booking counts with its shortest possible length: sittings grow with
+// table size, so no table it may take holds it for less than Item::end.
+bool overbooked(const Problem &problem)
+{
+    const ReservationEngine &engine = *problem.engine;
+    const TableCatalog &catalog = engine.tables();
+
+    struct Need
+    {
+        EpochSeconds start;
+        EpochSeconds end;
+        int seats;
+        bool vip;
+    };
+    std::vector<Need> needs;
+    for (const Item &item : problem.items) {
+        needs.push_back({item.start, item.end, item.minSeats,
+                         item.original >= 0 && catalog.isVIP(item.original)});
+    }
+    for (TableId id = 0; id < TableId(problem.fixed.size()); ++id) {
+        // One already under way on a closed table takes no table in service
+        if (!problem.inService[id])
+            continue;
+        for (const auto &booking : problem.fixed[id]) {
+            needs.push_back({booking.first, booking.second, catalog.seats(id), catalog.isVIP(id)});
+        }
+    }
+
+    std::set<std::pair<int, bool>> checked;
+    for (std::size_t i = 0; i < problem.items.size(); ++i) {
+        if (problem.initial[i] >= 0)
+            continue;
+        const Item &item = problem.items[i];
+        const bool vip = item.original >= 0 && catalog.isVIP(item.original);
+        if (!checked.insert({item.minSeats, vip}).second)
+            continue;
+
+        int supply = 0;
+        for (TableId id = 0; id < engine.tableCount(); ++id) {
+            if (problem.inService[id] && catalog.seats(id) >= item.minSeats && (catalog.isVIP(id) || !vip))
+                ++supply;
+        }
+
+        // Sweep the day; a booking ending as another starts frees its table first
+        std::vector<std::pair<EpochSeconds, int>> events;
+        for (const Need &need : needs) {
+            if (need.seats >= item.minSeats && (need.vip || !vip)) {
+                events.emplace_back(need.start, 1);
+                events.emplace_back(need.end, -1);
+            }
+        }
+        std::sort(events.begin(), events.end());
+        int active = 0;
+        for (const auto &event : events) {
+            active += event.second;
+            if (active > supply)
+                return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+ReseatingSolver::ReseatingSolver(const ReservationEngine &engine)
+    : engine(engine)
+{}
+
+void ReseatingSolver::setThreadCount(int threads)
+{
+    this->threads = std::max(0, threads);
+}
+
+void ReseatingSolver::setTimeLimit(std::chrono::milliseconds limit)
+{
+    timeLimit = limit;
+}
+
+ReseatingSolver::Plan ReseatingSolver::solve(const Request &request) const
+{
+    Plan plan;
+    const auto deadline = std::chrono::steady_clock::now() + timeLimit;
+
+    Problem problem;
+    problem.engine = &engine;
+    problem.inService.assign(engine.tableCount(), 1);
+    problem.sitting.resize(engine.tableCount());
+    for (TableId id = 0; id < engine.tableCount(); ++id) {
+        problem.sitting[id] = engine.sittingFor(id);
+    }
+    for (TableId id : request.outOfService) {
+        if (engine.isValid(id))
+            problem.inService[id] = 0;
+    }
+
+    // Every booking starting that day and not before request.notBefore is
+    // movable; anything else on the tables stays where it is
+    const TableCatalog &catalog = engine.tables();
+    const EpochSeconds dayStart = engine.slotStart(request.day, 0);
+    const EpochSeconds dayEnd = engine.slotStart(request.day, SlotGrid::kSlotsPerDay);
+    const EpochSeconds longest = std::max({engine.sittingPolicy().upToTwo, engine.sittingPolicy().upToFour,
+                                           engine.sittingPolicy().larger});
+    problem.fixed.resize(engine.tableCount());
+    for (TableId id = 0; id < engine.tableCount(); ++id) {
+        for (const auto &booking : engine.overlapping(id, dayStart - longest, dayEnd + longest)) {
+            if (booking.first < dayStart || booking.first >= dayEnd || booking.first < request.notBefore) {
+                problem.fixed[id].emplace(booking.first, booking.second);
+                continue;
+            }
+            Item item{booking.first, booking.second, id, catalog.seats(id),
+                      domainFor(engine, problem.inService, catalog.seats(id), catalog.isVIP(id))};
+            problem.items.push_back(std::move(item));
+            problem.initial.push_back(problem.inService[id] ? id : -1);
+            if (!problem.inService[id])
+                ++problem.mustMove;
+        }
+    }
+
+    for (const Booking &addition : request.additions) {
+        Item item{addition.start, addition.start + engine.sittingPolicy().lengthFor(addition.party), -1,
+                  addition.party, domainFor(engine, problem.inService, addition.party, false)};
+        problem.items.push_back(std::move(item));
+        problem.initial.push_back(-1);
+    }
+
+    const int displaced = static_cast<int>(std::count(problem.initial.begin(), problem.initial.end(), -1));
+    problem.maxDepth = 8 * displaced + 16;
+
+    if (overbooked(problem)) {
+        plan.optimal = true;
+        return plan;
+    }
+
+    Shared shared;
+    shared.deadline = deadline;
+
+    // Follow forced choices on one thread until the search actually branches
+    Search root(problem, shared);
+    std::vector<std::pair<int, Option>> prefix;
+    std::vector<Option> branches;
+    int branchItem = -1;
+    while (!root.done() && int(prefix.size()) < problem.maxDepth) {
+        branches = root.choose(branchItem);
+        if (branches.size() != 1)
+            break;
+        root.apply(branchItem, branches.front());
+        prefix.emplace_back(branchItem, branches.front());
+        branches.clear();
+    }
+
+    long nodes = static_cast<long>(prefix.size());
+    if (root.done()) {
+        root.record();
+    } else if (!branches.empty()) {
+        int workers = threads > 0 ? threads : int(std::thread::hardware_concurrency());
+        workers = std::max(1, std::min(workers, int(branches.size())));
+
+        // Deepen the move budget one booking at a time, so the first plan
+        // found moves as few bookings as possible; the greedy plan caps it
+        std::vector<TableId> first;
+        const int greedyCost = greedy(problem, first);
+        if (greedyCost != INT_MAX) {
+            shared.bestCost = greedyCost;
+            shared.best = first;
+        }
+
+        const int most = std::min(greedyCost - 1, static_cast<int>(problem.items.size()));
+        for (shared.limit = problem.mustMove; shared.limit <= most; ++shared.limit) {
+            std::atomic<std::size_t> next{0};
+            auto work = [&]() {
+                Search search(problem, shared);
+                for (const auto &step : prefix) {
+                    search.apply(step.first, step.second);
+                }
+                for (std::size_t i = next++; i < branches.size() && !shared.stop; i = next++) {
+                    search.apply(branchItem, branches[i]);
+                    search.run(int(prefix.size()) + 1);
+                    search.undo(branchItem, branches[i]);
+                }
+                shared.nodes += search.nodeCount();
+            };
+
+            std::vector<std::thread> pool;
+            for (int i = 1; i < workers; ++i) {
+                pool.emplace_back(work);
+            }
+            work();
+            for (std::thread &thread : pool) {
+                thread.join();
+            }
+
+            if (shared.stop)
+                break;
+        }
+    }
+
+    plan.nodes = nodes + shared.nodes;
+    plan.optimal = !shared.timedOut;
+    if (shared.bestCost == INT_MAX)
+        return plan;
+
+    plan.feasible = true;
+    plan.movedBookings = shared.bestCost;
+    for (std::size_t i = 0; i < problem.items.size(); ++i) {
+        const Item &item = problem.items[i];
+        if (item.original >= 0 && shared.best[i] != item.original)
+            plan.moves.push_back({item.original, shared.best[i], item.start, problem.endOn(item, shared.best[i])});
+    }
+    for (std::size_t i = 0; i < problem.items.size(); ++i) {
+        const Item &item = problem.items[i];
+        if (item.original < 0)
+            plan.moves.push_back({-1, shared.best[i], item.start, problem.endOn(item, shared.best[i])});
+    }
+    return plan;
+}
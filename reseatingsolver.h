@@ -0,0 +1,78 @@
+#ifndef RESEATINGSOLVER_H
+#define RESEATINGSOLVER_H
+
+#include <chrono>
+#include <vector>
+
+#include "reservationengine.h"
+
+// Re-plans one day's seating when a table goes out of service or a booking
+// only fits if others make room. Every booking that day that has not
+// started yet may change table, and the plan moves as few existing bookings
+// as possible.
+//
+// A moved booking needs a table with at least as many seats as its current
+// one, and a VIP table if it is on one now. Only start times are stored, so
+// a moved booking or an addition lasts its new table's sitting, exactly as
+// it will when the day is loaded again. Joined tables are re-seated one by
+// one.
+//
+// A seat-count sweep first rejects requests that cannot fit at all, and a
+// start-ordered best-fit pass gives the first plan. Branch and bound over
+// the displaced bookings then looks for one with fewer moves, deepening the
+// move budget one at a time. Forward checking picks the booking with the
+// fewest options next, and a booking with none cuts the branch. Each option
+// takes a free table or bumps up to kMaxBumped bookings, which are
+// displaced in turn; a booking is placed at most once per branch. The
+// root's options are shared out across threads that prune against one best
+// plan. When time runs out the best plan so far is returned.
+class ReseatingSolver
+{
+public:
+    static constexpr int kMaxBumped = 2;  // Bookings one placement may displace
+
+    struct Booking
+    {
+        int party;
+        EpochSeconds start;
+    };
+
+    struct Request
+    {
+        int day = 0;  // ReservationEngine::dayIndex of the day to re-plan
+        EpochSeconds notBefore = 0;  // Bookings starting earlier stay where they are
+        std::vector<TableId> outOfService;
+        std::vector<Booking> additions;
+    };
+
+    struct Move
+    {
+        TableId from;  // -1 for an addition
+        TableId to;
+        EpochSeconds start;
+        EpochSeconds end;
+    };
+
+    struct Plan
+    {
+        bool feasible = false;
+        bool optimal = false;      // The search finished inside the time limit
+        std::vector<Move> moves;   // Moved bookings, then additions
+        int movedBookings = 0;
+        long nodes = 0;
+    };
+
+    explicit ReseatingSolver(const ReservationEngine &engine);
+
+    void setThreadCount(int threads);  // 0 uses every hardware thread
+    void setTimeLimit(std::chrono::milliseconds limit);
+
+    Plan solve(const Request &request) const;
+
+private:
+    const ReservationEngine &engine;
+    int threads = 0;
+    std::chrono::milliseconds timeLimit{500};
+};
+
+#endif // RESEATINGSOLVER_H
@@ -0,0 +1,161 @@
+#include "reservationdatabase.h"
+
+#include <QDebug>
+#include <QSqlError>
+#include <QFileInfo>
+#include <QSettings>
+#include <QSqlQuery>
+#include <QStringList>
+
+#include "slotgrid.h"
+
+static ConnectionProfile activeProfile;
+
+static bool run(QSqlQuery &query, const QString &sql)
+{
+    if (!query.exec(sql)) {
+        qDebug() << "Reservation database statement failed:" << query.lastError().text() << sql;
+        return false;
+    }
+    return true;
+}
+
+ConnectionProfile ConnectionProfile::fromSettings(const QString &path)
+{
+    ConnectionProfile profile;
+    if (!QFileInfo::exists(path))
+        return profile;
+
+    QSettings settings(path, QSettings::IniFormat);
+    settings.beginGroup("database");
+    profile.journalMode = settings.value("journal_mode", profile.journalMode).toString();
+    profile.synchronous = settings.value("synchronous", profile.synchronous).toString();
+    profile.mmapSize = settings.value("mmap_size", profile.mmapSize).toLongLong();
+    profile.cacheSizeKiB = settings.value("cache_size_kib", profile.cacheSizeKiB).toInt();
+    profile.tempStoreInMemory = settings.value("temp_store_memory", profile.tempStoreInMemory).toBool();
+    profile.busyTimeoutMs = settings.value("busy_timeout_ms", profile.busyTimeoutMs).toInt();
+    settings.endGroup();
+    return profile;
+}
+
+bool ReservationDatabase::open(QSqlDatabase db, const ConnectionProfile &profile)
+{
+    activeProfile = profile;
+
+    // The driver sets the busy handler itself, before the first statement
+    db.setConnectOptions(QString("QSQLITE_BUSY_TIMEOUT=%1").arg(profile.busyTimeoutMs));
+    if (!db.open())
+        return false;
+
+    // journal_mode is stored in the database file, so it is only set here
+    QSqlQuery query(db);
+    run(query, QString("PRAGMA journal_mode = %1").arg(profile.journalMode));
+    return configure(db);
+}
+
+bool ReservationDatabase::configure(QSqlDatabase db)
+{
+    const ConnectionProfile &profile = activeProfile;
+    const QStringList pragmas = {
+        QString("PRAGMA synchronous = %1").arg(profile.synchronous),
+        QString("PRAGMA mmap_size = %1").arg(profile.mmapSize),
+        QString("PRAGMA cache_size = -%1").arg(profile.cacheSizeKiB),  // Negative means KiB
+        QString("PRAGMA temp_store = %1").arg(profile.tempStoreInMemory ? "MEMORY" : "DEFAULT"),
+        QString("PRAGMA busy_timeout = %1").arg(profile.busyTimeoutMs),
+    };
+
+    QSqlQuery query(db);
+    bool ok = true;
+    for (const QString &pragma : pragmas) {
+        ok = run(query, pragma) && ok;
+    }
+    return ok;
+}
+
+QString ReservationDatabase::describe(QSqlDatabase db)
+{
+    QStringList settings;
+    QSqlQuery query(db);
+    for (const char *pragma : {"journal_mode", "synchronous", "mmap_size", "cache_size",
+                               "temp_store", "busy_timeout"}) {
+        QString value = "?";
+        if (query.exec(QString("PRAGMA %1").arg(pragma)) && query.next()) {
+            value = query.value(0).toString();
+        }
+        settings << QString("%1=%2").arg(QLatin1String(pragma), value);
+    }
+    return settings.join(", ");
+}
+
+bool ReservationDatabase::migrate(QSqlDatabase db)
+{
+    QSqlQuery query(db);
+    if (!run(query, "PRAGMA user_version") || !query.next())
+        return false;
+    const int version = query.value(0).toInt();
+    if (version >= kSchemaVersion)
+        return true;
+
+    if (!run(query, "SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'reservations'"))
+        return false;
+    const bool hasLegacyTable = query.next();
+
+    if (!db.transaction())
+        return false;
+
+    QStringList steps;
+    if (version < 1) {
+        steps << "CREATE TABLE reservations_v1 ("
+                 "table_id TEXT NOT NULL, "
+                 "reservation_time INTEGER NOT NULL, "
+                 "username TEXT NOT NULL)";
+
+        if (hasLegacyTable) {
+            // Legacy rows hold QDateTime ISO strings in local time, unless they
+            // carry an explicit Z or +HH:MM offset
+            steps << "INSERT INTO reservations_v1 (table_id, reservation_time, username) "
+                     "SELECT table_id, "
+                     "       CASE WHEN typeof(reservation_time) = 'integer' THEN reservation_time "
+                     "            WHEN reservation_time LIKE '%Z' "
+                     "              OR reservation_time GLOB '*[+-][0-9][0-9]:[0-9][0-9]' "
+                     "            THEN CAST(strftime('%s', reservation_time) AS INTEGER) "
+                     "            ELSE CAST(strftime('%s', reservation_time, 'utc') AS INTEGER) END, "
+                     "       username "
+                     "FROM reservations WHERE reservation_time IS NOT NULL"
+                  << "DROP TABLE reservations";
+        }
+
+        // Each index also carries the remaining selected column, so the list
+        // queries are answered from the index alone
+        steps << "ALTER TABLE reservations_v1 RENAME TO reservations"
+              << "CREATE INDEX IF NOT EXISTS reservations_by_user "
+                 "ON reservations (username, reservation_time, table_id)"
+              << "CREATE INDEX IF NOT EXISTS reservations_by_table "
+                 "ON reservations (table_id, reservation_time)"
+              << "CREATE INDEX IF NOT EXISTS reservations_by_time "
+                 "ON reservations (reservation_time, table_id)";
+    }
+
+    if (version < 2) {
+        // One booking per table and slot, enforced by SQLite itself so two
+        // terminals can never both insert the same slot. Rows that already
+        // collide keep the earliest booking.
+        steps << QString("ALTER TABLE reservations ADD COLUMN slot_start INTEGER "
+                         "GENERATED ALWAYS AS (reservation_time - reservation_time % %1) VIRTUAL")
+                     .arg(SlotGrid::kSlotSeconds)
+              << "DELETE FROM reservations WHERE rowid NOT IN "
+                 "(SELECT MIN(rowid) FROM reservations GROUP BY table_id, slot_start)"
+              << "CREATE UNIQUE INDEX IF NOT EXISTS reservations_slot "
+                 "ON reservations (table_id, slot_start)";
+    }
+
+    steps << QString("PRAGMA user_version = %1").arg(kSchemaVersion);
+
+    for (const QString &step : steps) {
+        if (!run(query, step)) {
+            db.rollback();
+            return false;
+        }
+    }
+    return db.commit();
+}
@@ -0,0 +1,47 @@
+#ifndef RESERVATIONDATABASE_H
+#define RESERVATIONDATABASE_H
+
+#include <QSqlDatabase>
+#include <QString>
+
+// Settings applied to every connection to testdb.db when it is opened.
+// The defaults favour many short reads (the dashboard) running next to
+// small writes (bookings): WAL lets readers and the writer proceed without
+// blocking each other, and NORMAL sync only fsyncs at checkpoints.
+struct ConnectionProfile
+{
+    QString journalMode = "WAL";
+    QString synchronous = "NORMAL";
+    qint64 mmapSize = 256 * 1024 * 1024;
+    int cacheSizeKiB = 16 * 1024;
+    bool tempStoreInMemory = true;
+    int busyTimeoutMs = 5000;
+
+    // Overrides from the [database] group of an INI file, if it exists
+    static ConnectionProfile fromSettings(const QString &path);
+};
+
+// Schema of the reservations table in testdb.db. Times are INTEGER epoch
+// seconds so range predicates run on the indexes instead of on parsed ISO
+// strings. Inserts are conditional on no booking on the table starting
+// within its sitting, so overlapping bookings cannot both be written; a
+// UNIQUE index on (table_id, slot_start) backs this up for the exact slot.
+// Older databases are upgraded in place, tracked through PRAGMA user_version.
+class ReservationDatabase
+{
+public:
+    static constexpr int kSchemaVersion = 2;
+
+    // Opens `db` with `profile` applied and remembers the profile for
+    // connections opened later through configure()
+    static bool open(QSqlDatabase db, const ConnectionProfile &profile);
+    // Applies the remembered profile's per-connection pragmas to another
+    // connection, e.g. one cloned for a worker thread
+    static bool configure(QSqlDatabase db);
+    // Active settings as SQLite reports them, for the startup log
+    static QString describe(QSqlDatabase db = QSqlDatabase::database());
+
+    static bool migrate(QSqlDatabase db = QSqlDatabase::database());
+};
+
+#endif // RESERVATIONDATABASE_H
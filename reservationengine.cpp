@@ -0,0 +1,349 @@
+#include "reservationengine.h"
+
+#include "availabilitykernel.h"
+
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+ReservationEngine::ReservationEngine(const SittingPolicy &policy)
+    : policy(policy)
+{}
+
+TableId ReservationEngine::addTable(const std::string &name, int seats, bool isVIP, double minSpend)
+{
+    auto existing = idsByName.find(name);
+    if (existing != idsByName.end()) {
+        TableId id = existing->second;
+        int oldSeats = catalog.seats(id);
+        catalog.update(id, seats, isVIP, minSpend);
+        if (OccupancySummary::classFor(oldSeats) != OccupancySummary::classFor(seats)) {
+            // Its busy slots now count towards another class
+            summary.removeTable(oldSeats);
+            summary.addTable(seats);
+            rebuildGrid();
+        }
+        return id;
+    }
+
+    TableId id = catalog.add(name, seats, isVIP, minSpend);
+    summary.addTable(seats);
+    slots.emplace_back();
+    idsByName.emplace(name, id);
+    grid.resize(tableCount());
+    return id;
+}
+
+TableId ReservationEngine::tableId(const std::string &name) const
+{
+    auto it = idsByName.find(name);
+    return it == idsByName.end() ? -1 : it->second;
+}
+
+EngineTable ReservationEngine::table(TableId id) const
+{
+    if (!isValid(id))
+        throw std::out_of_range("ReservationEngine: unknown table id");
+    return EngineTable{catalog.name(id), catalog.seats(id), catalog.isVIP(id), catalog.minSpend(id)};
+}
+
+EpochSeconds ReservationEngine::sittingFor(TableId id) const
+{
+    return isValid(id) ? policy.lengthFor(catalog.seats(id)) : policy.larger;
+}
+
+bool ReservationEngine::reserve(TableId id, EpochSeconds start)
+{
+    return reserve(id, start, start + sittingFor(id));
+}
+
+bool ReservationEngine::reserve(TableId id, EpochSeconds start, EpochSeconds end)
+{
+    if (!isValid(id) || end <= start)
+        return false;
+    if (!isFree(id, start, end))
+        return false;
+
+    slots[id].emplace(start, end);
+    refreshGrid(id, start, end);
+    return true;
+}
+
+bool ReservationEngine::restore(TableId id, EpochSeconds start)
+{
+    if (!isValid(id))
+        return false;
+
+    SlotIndex &index = slots[id];
+    auto next = index.lower_bound(start);
+    if (next != index.end() && next->first == start)
+        return false;
+
+    EpochSeconds end = start + sittingFor(id);
+    if (next != index.end() && next->first < end)
+        end = next->first;
+
+    if (next != index.begin()) {
+        auto previous = std::prev(next);
+        if (previous->second > start) {
+            EpochSeconds previousEnd = previous->second;
+            previous->second = start;
+            refreshGrid(id, start, previousEnd);
+        }
+    }
+
+    index.emplace_hint(next, start, end);
+    refreshGrid(id, start, end);
+    return true;
+}
+
+bool ReservationEngine::cancel(TableId id, EpochSeconds start)
+{
+    if (!isValid(id))
+        return false;
+
+    auto it = slots[id].find(start);
+    if (it == slots[id].end())
+        return false;
+
+    EpochSeconds end = it->second;
+    slots[id].erase(it);
+    refreshGrid(id, start, end);
+    return true;
+}
+
+void ReservationEngine::clearReservations()
+{
+    for (SlotIndex &index : slots) {
+        index.clear();
+    }
+    grid.clear();
+    summary.clear();
+}
+
+void ReservationEngine::setUtcOffset(UtcOffset offsetAt)
+{
+    // Day and slot boundaries move, so rebuild the grid from the index
+    utcOffset = std::move(offsetAt);
+    rebuildGrid();
+}
+
+void ReservationEngine::setUtcOffset(int seconds)
+{
+    setUtcOffset([seconds](EpochSeconds) { return seconds; });
+}
+
+int ReservationEngine::offsetAt(EpochSeconds time) const
+{
+    return utcOffset ? utcOffset(time) : 0;
+}
+
+int ReservationEngine::dayOffset(int day) const
+{
+    // DST changes happen overnight, outside the grid's opening hours, so
+    // the offset at local noon holds for every slot of the day
+    EpochSeconds noon = EpochSeconds(day) * 86400 + 12 * 3600;
+    return offsetAt(noon - offsetAt(noon));
+}
+
+void ReservationEngine::rebuildGrid()
+{
+    grid.clear();
+    summary.clear();
+    for (TableId id = 0; id < tableCount(); ++id) {
+        for (const auto &reservation : slots[id]) {
+            refreshGrid(id, reservation.first, reservation.second);
+        }
+    }
+}
+
+int ReservationEngine::dayIndex(EpochSeconds time) const
+{
+    EpochSeconds local = time + offsetAt(time);
+    EpochSeconds day = local / 86400;
+    if (local % 86400 < 0)
+        --day;
+    return static_cast<int>(day);
+}
+
+int ReservationEngine::slotIndex(EpochSeconds time) const
+{
+    EpochSeconds local = time + offsetAt(time);
+    EpochSeconds secondOfDay = local % 86400;
+    if (secondOfDay < 0)
+        secondOfDay += 86400;
+    return SlotGrid::slotForSecondOfDay(static_cast<int>(secondOfDay));
+}
+
+EpochSeconds ReservationEngine::slotStart(int day, int slot) const
+{
+    return EpochSeconds(day) * 86400 - dayOffset(day) + SlotGrid::secondOfDayForSlot(slot);
+}
+
+void ReservationEngine::refreshGrid(TableId id, EpochSeconds start, EpochSeconds end)
+{
+    // Re-derive every grid slot touched by [start, end) from the index, so a
+    // slot shared by two back-to-back reservations stays busy when only one
+    // of them is cancelled.
+    for (int day = dayIndex(start); day <= dayIndex(end - 1); ++day) {
+        const EpochSeconds midnight = EpochSeconds(day) * 86400 - dayOffset(day);
+        for (int slot = 0; slot < SlotGrid::kSlotsPerDay; ++slot) {
+            EpochSeconds from = midnight + SlotGrid::secondOfDayForSlot(slot);
+            EpochSeconds to = from + SlotGrid::kSlotSeconds;
+            if (to <= start || from >= end)
+                continue;
+            bool busy = !isFree(id, from, to);
+            if (grid.isBusy(day, id, slot) != busy) {
+                grid.setBusy(day, id, slot, busy);
+                summary.add(day, slot, catalog.seats(id), busy ? 1 : -1);
+            }
+        }
+    }
+}
+
+bool ReservationEngine::isFree(TableId id, EpochSeconds start) const
+{
+    return isFree(id, start, start + sittingFor(id));
+}
+
+std::vector<ReservationEngine::Interval> ReservationEngine::overlapping(TableId id, EpochSeconds from,
+                                                                        EpochSeconds to) const
+{
+    std::vector<Interval> result;
+    if (!isValid(id) || to <= from)
+        return result;
+
+    // Only the reservation starting just before `from` can reach into the
+    // range from the left; everything after it is in start order
+    const SlotIndex &index = slots[id];
+    auto it = index.lower_bound(from);
+    if (it != index.begin() && std::prev(it)->second > from)
+        --it;
+    for (; it != index.end() && it->first < to; ++it) {
+        result.emplace_back(it->first, it->second);
+    }
+    return result;
+}
+
+bool ReservationEngine::isFree(TableId id, EpochSeconds start, EpochSeconds end) const
+{
+    if (!isValid(id))
+        return false;
+
+    const SlotIndex &index = slots[id];
+
+    // First reservation starting at or after `start` must begin after `end`...
+    auto next = index.lower_bound(start);
+    if (next != index.end() && next->first < end)
+        return false;
+
+    // ...and the one starting before it must already be over.
+    if (next != index.begin() && std::prev(next)->second > start)
+        return false;
+
+    return true;
+}
+
+bool ReservationEngine::isReservedAt(TableId id, EpochSeconds start) const
+{
+    return isValid(id) && slots[id].count(start) > 0;
+}
+
+std::vector<TableId> ReservationEngine::freeTablesAt(EpochSeconds start) const
+{
+    std::vector<TableId> result;
+    for (TableId id = 0; id < tableCount(); ++id) {
+        if (isFree(id, start))
+            result.push_back(id);
+    }
+    return result;
+}
+
+std::vector<TableId> ReservationEngine::freeTablesAt(EpochSeconds start, EpochSeconds end) const
+{
+    std::vector<TableId> result;
+    for (TableId id = 0; id < tableCount(); ++id) {
+        if (isFree(id, start, end))
+            result.push_back(id);
+    }
+    return result;
+}
+
+SlotGrid::Word ReservationEngine::slotMask(int firstSlot, int lastSlot)
+{
+    if (firstSlot < 0)
+        firstSlot = 0;
+    if (lastSlot > SlotGrid::kSlotsPerDay)
+        lastSlot = SlotGrid::kSlotsPerDay;
+    if (lastSlot <= firstSlot)
+        return 0;
+
+    SlotGrid::Word upTo = lastSlot >= SlotGrid::kWordBits ? ~SlotGrid::Word(0)
+                                                          : (SlotGrid::Word(1) << lastSlot) - 1;
+    return upTo & ~((SlotGrid::Word(1) << firstSlot) - 1);
+}
+
+std::vector<TableId> ReservationEngine::findFreeTables(int day, int firstSlot, int lastSlot,
+                                                       int minSeats, int maxSeats) const
+{
+    std::vector<TableId> result;
+    AvailabilityKernel::findFreeTables(catalog.seatData(), grid.tableWords(day), tableCount(),
+                                       slotMask(firstSlot, lastSlot), minSeats, maxSeats, result);
+    return result;
+}
+
+std::vector<TableId> ReservationEngine::findFreeTables(EpochSeconds start, EpochSeconds end,
+                                                       int minSeats, int maxSeats) const
+{
+    // Slot-aligned ranges inside one day map exactly onto the bitmaps
+    int day = dayIndex(start);
+    int firstSlot = slotIndex(start);
+    int lastSlot = slotIndex(end - 1);
+    bool aligned = firstSlot >= 0 && lastSlot >= 0 && dayIndex(end - 1) == day
+                   && slotStart(day, firstSlot) == start
+                   && slotStart(day, lastSlot) + SlotGrid::kSlotSeconds == end;
+    if (aligned)
+        return findFreeTables(day, firstSlot, lastSlot + 1, minSeats, maxSeats);
+
+    // Anything else falls back to the per-table interval index
+    std::vector<TableId> result;
+    for (TableId id = 0; id < tableCount(); ++id) {
+        int seats = catalog.seats(id);
+        if (seats >= minSeats && seats <= maxSeats && isFree(id, start, end))
+            result.push_back(id);
+    }
+    return result;
+}
+
+std::vector<TableId> ReservationEngine::tablesWithSeats(int minSeats, int maxSeats) const
+{
+    // An empty slot mask turns the kernel into a pure seat-range filter
+    std::vector<TableId> result;
+    AvailabilityKernel::findFreeTables(catalog.seatData(), nullptr, tableCount(), 0, minSeats, maxSeats, result);
+    return result;
+}
+
+int ReservationEngine::countStarts(TableId id, EpochSeconds from, EpochSeconds to) const
+{
+    if (!isValid(id) || to <= from)
+        return 0;
+
+    const SlotIndex &index = slots[id];
+    return static_cast<int>(std::distance(index.lower_bound(from), index.lower_bound(to)));
+}
+
+int ReservationEngine::totalReservations() const
+{
+    std::size_t total = 0;
+    for (const SlotIndex &index : slots) {
+        total += index.size();
+    }
+    return static_cast<int>(total);
+}
+
+const ReservationEngine::SlotIndex &ReservationEngine::reservations(TableId id) const
+{
+    if (!isValid(id))
+        throw std::out_of_range("ReservationEngine: unknown table id");
+    return slots[id];
+}
@@ -0,0 +1,128 @@
+#ifndef RESERVATIONENGINE_H
+#define RESERVATIONENGINE_H
+
+#include <climits>
+#include <functional>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "occupancysummary.h"
+#include "reservationtypes.h"
+#include "slotgrid.h"
+#include "tablecatalog.h"
+
+struct EngineTable
+{
+    std::string name;
+    int seats;
+    bool isVIP;
+    double minSpend;
+};
+
+// How long a booking holds its table. Bookings record a table and a start
+// time but no party size, so the table's seat count stands in for the party:
+// a 2-top turns over faster than a 4-top, and the big VIP tables get the
+// longest sitting.
+struct SittingPolicy
+{
+    EpochSeconds upToTwo = 60 * 60;
+    EpochSeconds upToFour = 90 * 60;
+    EpochSeconds larger = 120 * 60;
+
+    EpochSeconds lengthFor(int guests) const
+    {
+        return guests <= 2 ? upToTwo : guests <= 4 ? upToFour : larger;
+    }
+};
+
+// The engine is plain C++ (no Qt) so the Crow server can link it as well as
+// the desktop client.
+class ReservationEngine
+{
+public:
+    // Per-table interval tree of reservations: start time -> end time, as a
+    // red-black tree keyed on start. Intervals on one table never overlap, so
+    // their ends are sorted too and the subtree max-end of a general interval
+    // tree is not needed: an overlap query is one lower_bound plus a walk
+    // over the k hits.
+    using SlotIndex = std::map<EpochSeconds, EpochSeconds>;
+    using Interval = std::pair<EpochSeconds, EpochSeconds>;
+
+    explicit ReservationEngine(const SittingPolicy &policy = SittingPolicy());
+
+    // Table catalog
+    TableId addTable(const std::string &name, int seats, bool isVIP, double minSpend = 0.0);
+    TableId tableId(const std::string &name) const;  // -1 if the table is unknown
+    EngineTable table(TableId id) const;
+    const TableCatalog &tables() const { return catalog; }
+    int tableCount() const { return catalog.size(); }
+    bool isValid(TableId id) const { return id >= 0 && id < tableCount(); }
+    const SittingPolicy &sittingPolicy() const { return policy; }
+    EpochSeconds sittingFor(TableId id) const;  // Sitting length at this table
+
+    // Seconds local time is ahead of UTC at a given instant, used to map
+    // epoch times onto the SlotGrid day grid. It is asked per date, so days
+    // on the other side of a DST change keep their 11:00-23:00 slots. Must
+    // be safe to call from several threads at once.
+    using UtcOffset = std::function<int(EpochSeconds)>;
+    void setUtcOffset(UtcOffset offsetAt);
+    void setUtcOffset(int seconds);  // Fixed offset, no DST
+    int dayIndex(EpochSeconds time) const;
+    int slotIndex(EpochSeconds time) const;  // -1 outside opening hours
+    EpochSeconds slotStart(int day, int slot) const;
+    const SlotGrid &slotGrid() const { return grid; }
+    const OccupancySummary &occupancy() const { return summary; }
+
+    // Reservations. Without an end time a booking lasts the table's sitting.
+    bool reserve(TableId id, EpochSeconds start);
+    bool reserve(TableId id, EpochSeconds start, EpochSeconds end);
+    // Loads a stored booking. Bookings made under a shorter sitting may now
+    // overlap their neighbours, so instead of being refused the earlier one
+    // is cut short at `start` and this one ends where the next one begins.
+    // False only if a booking already starts at `start`.
+    bool restore(TableId id, EpochSeconds start);
+    bool cancel(TableId id, EpochSeconds start);
+    void clearReservations();
+
+    // Per-table queries are O(log n) in the number of reservations on the
+    // table, plus O(k) for the k reservations they return or count
+    std::vector<Interval> overlapping(TableId id, EpochSeconds from, EpochSeconds to) const;  // O(log n + k)
+    bool isFree(TableId id, EpochSeconds start) const;
+    bool isFree(TableId id, EpochSeconds start, EpochSeconds end) const;
+    bool isReservedAt(TableId id, EpochSeconds start) const;
+    std::vector<TableId> freeTablesAt(EpochSeconds start) const;
+    std::vector<TableId> freeTablesAt(EpochSeconds start, EpochSeconds end) const;
+
+    // Free tables with minSeats <= seats <= maxSeats, answered in one
+    // AvailabilityKernel pass over the catalog and that day's slot bitmaps.
+    // Slots are the half-open range [firstSlot, lastSlot).
+    std::vector<TableId> findFreeTables(int day, int firstSlot, int lastSlot,
+                                        int minSeats, int maxSeats = INT_MAX) const;
+    std::vector<TableId> findFreeTables(EpochSeconds start, EpochSeconds end,
+                                        int minSeats, int maxSeats = INT_MAX) const;
+    std::vector<TableId> tablesWithSeats(int minSeats, int maxSeats = INT_MAX) const;
+    static SlotGrid::Word slotMask(int firstSlot, int lastSlot);
+
+    // Number of reservations on a table starting in [from, to), O(log n + k)
+    int countStarts(TableId id, EpochSeconds from, EpochSeconds to) const;
+    int totalReservations() const;
+    const SlotIndex &reservations(TableId id) const;
+
+private:
+    void refreshGrid(TableId id, EpochSeconds start, EpochSeconds end);
+    void rebuildGrid();
+    int offsetAt(EpochSeconds time) const;
+    int dayOffset(int day) const;
+
+    SittingPolicy policy;
+    UtcOffset utcOffset;  // Empty means UTC
+    SlotGrid grid;
+    OccupancySummary summary;  // Follows every change to grid
+    TableCatalog catalog;
+    std::vector<SlotIndex> slots;
+    std::unordered_map<std::string, TableId> idsByName;
+};
+
+#endif // RESERVATIONENGINE_H
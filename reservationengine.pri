@@ -0,0 +1,24 @@
+# GUI-free reservation engine shared by the desktop client (restaurant1.pro)
+# and the Crow server (server.pro). Pure C++17, no Qt modules required.
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+SOURCES += \
+    $$PWD/availabilitykernel.cpp \
+    $$PWD/occupancysummary.cpp \
+    $$PWD/reseatingsolver.cpp \
+    $$PWD/reservationengine.cpp \
+    $$PWD/slotgrid.cpp \
+    $$PWD/tableassigner.cpp \
+    $$PWD/tablecatalog.cpp \
+
+HEADERS += \
+    $$PWD/availabilitykernel.h \
+    $$PWD/occupancysummary.h \
+    $$PWD/reseatingsolver.h \
+    $$PWD/reservationengine.h \
+    $$PWD/reservationtypes.h \
+    $$PWD/slotgrid.h \
+    $$PWD/tableassigner.h \
+    $$PWD/tablecatalog.h \
@@ -0,0 +1,157 @@
+#include "reservationjournal.h"
+
+#include <QtEndian>
+
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+static const char kMagic[8] = {'R', 'S', 'V', 'J', 'N', 'L', 0, 1};
+
+static void encode(const ReservationJournal::Record &record, char *out)
+{
+    std::memset(out, 0, ReservationJournal::kRecordSize);
+    out[0] = char(record.op);
+    qToLittleEndian<qint32>(record.table, out + 4);
+    qToLittleEndian<qint64>(record.time, out + 8);
+    qToLittleEndian<qint32>(record.userId, out + 16);
+}
+
+static bool decode(const char *in, ReservationJournal::Record &record)
+{
+    quint8 op = quint8(in[0]);
+    if (op < ReservationJournal::Reserve || op > ReservationJournal::InService)
+        return false;
+
+    record.op = ReservationJournal::Op(op);
+    record.table = qFromLittleEndian<qint32>(in + 4);
+    record.time = qFromLittleEndian<qint64>(in + 8);
+    record.userId = qFromLittleEndian<qint32>(in + 16);
+    return true;
+}
+
+ReservationJournal::ReservationJournal(const QString &path, QObject *parent)
+    : QObject(parent)
+    , file(path)
+{
+    syncTimer.setSingleShot(true);
+    syncTimer.setInterval(kSyncDelayMs);
+    connect(&syncTimer, &QTimer::timeout, this, &ReservationJournal::sync);
+}
+
+ReservationJournal::~ReservationJournal()
+{
+    sync();
+}
+
+bool ReservationJournal::open()
+{
+    if (file.isOpen())
+        return true;
+
+    if (!file.open(QIODevice::ReadWrite))
+        return false;
+
+    // A new or headerless file starts over with just the header
+    char header[sizeof(kMagic)];
+    if (file.read(header, sizeof(header)) != qint64(sizeof(header))
+        || std::memcmp(header, kMagic, sizeof(kMagic)) != 0) {
+        file.resize(0);
+        file.seek(0);
+        file.write(kMagic, sizeof(kMagic));
+        file.flush();
+    }
+
+    // Appends go after the last whole record, overwriting any torn tail
+    qint64 body = file.size() - qint64(sizeof(kMagic));
+    records = int(body / kRecordSize);
+    file.seek(qint64(sizeof(kMagic)) + qint64(records) * kRecordSize);
+    return true;
+}
+
+int ReservationJournal::replay(const std::function<void(const Record &)> &apply)
+{
+    if (!open())
+        return 0;
+
+    file.seek(sizeof(kMagic));
+    QByteArray body = file.read(qint64(records) * kRecordSize);
+    int replayed = 0;
+    Record record;
+    for (int offset = 0; offset + kRecordSize <= body.size(); offset += kRecordSize) {
+        if (decode(body.constData() + offset, record)) {
+            apply(record);
+            ++replayed;
+        }
+    }
+
+    file.seek(qint64(sizeof(kMagic)) + qint64(records) * kRecordSize);
+
+    // A journal left long by an earlier run is compacted now
+    checkCompaction();
+    return replayed;
+}
+
+bool ReservationJournal::append(const Record &record)
+{
+    if (!open())
+        return false;
+
+    char bytes[kRecordSize];
+    encode(record, bytes);
+    if (file.write(bytes, kRecordSize) != kRecordSize)
+        return false;
+
+    ++records;
+    if (++unsynced >= kSyncBatch) {
+        sync();
+    } else if (!syncTimer.isActive()) {
+        syncTimer.start();
+    }
+
+    checkCompaction();
+    return true;
+}
+
+void ReservationJournal::checkCompaction()
+{
+    if (records < compactAt)
+        return;
+
+    // Not again on every append if this attempt fails
+    compactAt = records + kCompactRetry;
+    emit compactionDue();
+}
+
+void ReservationJournal::sync()
+{
+    syncTimer.stop();
+    if (!file.isOpen() || unsynced == 0)
+        return;
+
+    file.flush();
+#ifdef Q_OS_WIN
+    _commit(file.handle());
+#else
+    ::fsync(file.handle());
+#endif
+    unsynced = 0;
+}
+
+void ReservationJournal::reset()
+{
+    if (!open())
+        return;
+
+    syncTimer.stop();
+    file.resize(sizeof(kMagic));
+    file.seek(sizeof(kMagic));
+    file.flush();
+    records = 0;
+    unsynced = 0;
+    compactAt = kCompactAfter;
+}
@@ -0,0 +1,74 @@
+#ifndef RESERVATIONJOURNAL_H
+#define RESERVATIONJOURNAL_H
+
+#include <QFile>
+#include <QObject>
+#include <QTimer>
+
+#include <functional>
+
+#include "reservationtypes.h"
+
+// Append-only log of reservation changes made since the last snapshot.
+// Every booking or cancel costs one fixed-size record instead of a rewrite
+// of reservations.json. Appends are flushed and fsynced in batches; once the
+// log holds kCompactAfter records the owner is asked to compact it into a
+// fresh snapshot, and asked again every kCompactRetry records until reset()
+// shows it did.
+class ReservationJournal : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Op : quint8 {
+        Reserve = 1,
+        Cancel = 2,
+        OutOfService = 3,  // The table was closed at `time`
+        InService = 4,
+    };
+
+    struct Record
+    {
+        Op op;
+        TableId table;
+        EpochSeconds time;
+        qint32 userId;
+    };
+
+    // On-disk record: op (1), padding (3), table (4), time (8), user (4),
+    // padding (4), all little endian
+    static constexpr int kRecordSize = 24;
+    static constexpr int kSyncBatch = 32;
+    static constexpr int kSyncDelayMs = 250;
+    static constexpr int kCompactAfter = 4096;
+    static constexpr int kCompactRetry = 256;  // Records between asks until a compaction succeeds
+
+    explicit ReservationJournal(const QString &path, QObject *parent = nullptr);
+    ~ReservationJournal() override;
+
+    // Replays every intact record in order; a torn tail record is ignored.
+    // Returns the number of records replayed.
+    int replay(const std::function<void(const Record &)> &apply);
+
+    bool append(const Record &record);
+    void sync();
+
+    // Drops every record, called once a snapshot holds their effect
+    void reset();
+    int size() const { return records; }
+
+signals:
+    void compactionDue();
+
+private:
+    bool open();
+    void checkCompaction();
+
+    QFile file;
+    QTimer syncTimer;
+    int records = 0;
+    int unsynced = 0;
+    int compactAt = kCompactAfter;  // Record count that next emits compactionDue
+};
+
+#endif // RESERVATIONJOURNAL_H
@@ -0,0 +1,181 @@
+#include "reservationlistmodel.h"
+
+#include <QAbstractItemView>
+#include <QCursor>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPainterPath>
+
+// Card geometry, matching the widget cards the list used to build
+static const int kCardHeight = 84;
+static const int kCardSpacing = 8;
+static const int kCardPadding = 16;
+static const int kCancelWidth = 100;
+static const int kCancelHeight = 34;
+
+ReservationListModel::ReservationListModel(QObject *parent)
+    : QAbstractListModel(parent)
+{}
+
+void ReservationListModel::reset()
+{
+    beginResetModel();
+    rows.clear();
+    more = false;
+    fetching = true;  // The first page is on its way
+    endResetModel();
+}
+
+void ReservationListModel::appendRows(const QVector<ReservationRow> &page, bool more)
+{
+    this->more = more;
+    fetching = false;
+    if (page.isEmpty())
+        return;
+
+    beginInsertRows(QModelIndex(), rows.size(), rows.size() + page.size() - 1);
+    rows.append(page);
+    endInsertRows();
+}
+
+void ReservationListModel::removeReservation(int index)
+{
+    if (index < 0 || index >= rows.size())
+        return;
+
+    beginRemoveRows(QModelIndex(), index, index);
+    rows.removeAt(index);
+    endRemoveRows();
+}
+
+int ReservationListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : rows.size();
+}
+
+QVariant ReservationListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rows.size())
+        return QVariant();
+
+    const ReservationRow &reservation = rows[index.row()];
+    switch (role) {
+    case Qt::DisplayRole:
+    case TableNameRole:
+        return reservation.tableName;
+    case TableIdRole:
+        return reservation.table;
+    case TimeRole:
+        return reservation.time;
+    case VIPRole:
+        return reservation.isVIP;
+    default:
+        return QVariant();
+    }
+}
+
+bool ReservationListModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && more && !fetching;
+}
+
+void ReservationListModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent))
+        return;
+
+    fetching = true;
+    emit fetchRequested();
+}
+
+QRect ReservationCardDelegate::cardRect(const QRect &itemRect)
+{
+    return itemRect.adjusted(0, 0, -1, -kCardSpacing - 1);
+}
+
+QRect ReservationCardDelegate::cancelRect(const QRect &itemRect)
+{
+    QRect card = cardRect(itemRect);
+    return QRect(card.right() - kCardPadding - kCancelWidth,
+                 card.center().y() - kCancelHeight / 2,
+                 kCancelWidth, kCancelHeight);
+}
+
+QSize ReservationCardDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    Q_UNUSED(index);
+    return QSize(option.rect.width(), kCardHeight + kCardSpacing);
+}
+
+void ReservationCardDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    const QString tableName = index.data(ReservationListModel::TableNameRole).toString();
+    const QDateTime time = index.data(ReservationListModel::TimeRole).toDateTime();
+    const bool isVIP = index.data(ReservationListModel::VIPRole).toBool();
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+
+    const QRect card = cardRect(option.rect);
+    painter->setPen(QPen(QColor("#E0E0E0"), 1));
+    painter->setBrush(Qt::white);
+    painter->drawRoundedRect(card, 8, 8);
+
+    QRect content = card.adjusted(kCardPadding, kCardPadding, -kCardPadding, -kCardPadding);
+    QFont base = option.font;
+
+    // Table number
+    QFont bold = base;
+    bold.setBold(true);
+    painter->setFont(bold);
+    painter->setPen(QColor("#1B4965"));
+    QRect tableRect(content.left(), content.top(), 100, content.height());
+    painter->drawText(tableRect, Qt::AlignLeft | Qt::AlignVCenter,
+                      QString("Table %1").arg(tableName.mid(5)));
+
+    // Date over time
+    painter->setFont(base);
+    QRect whenRect(tableRect.right() + 8, content.top(), 160, content.height() / 2);
+    painter->setPen(QColor("#2C3E50"));
+    painter->drawText(whenRect, Qt::AlignLeft | Qt::AlignBottom, time.toString("MMM d, yyyy"));
+    painter->setPen(QColor("#6C757D"));
+    painter->drawText(whenRect.translated(0, whenRect.height()), Qt::AlignLeft | Qt::AlignTop,
+                      time.toString("h:mm AP"));
+
+    // Status
+    QRect statusRect(whenRect.right() + 8, content.top(), 100, content.height());
+    painter->setFont(isVIP ? bold : base);
+    painter->setPen(QColor(isVIP ? "#FFB400" : "#6C757D"));
+    painter->drawText(statusRect, Qt::AlignLeft | Qt::AlignVCenter, isVIP ? "VIP" : "Standard");
+
+    // Cancel button
+    const QRect cancel = cancelRect(option.rect);
+    bool hovered = false;
+    // Item rects are in viewport coordinates, not the view's
+    const QAbstractItemView *view = qobject_cast<const QAbstractItemView *>(option.widget);
+    if ((option.state & QStyle::State_MouseOver) && view) {
+        hovered = cancel.contains(view->viewport()->mapFromGlobal(QCursor::pos()));
+    }
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(QColor(hovered ? "#C82333" : "#DC3545"));
+    painter->drawRoundedRect(cancel, 4, 4);
+    painter->setFont(base);
+    painter->setPen(Qt::white);
+    painter->drawText(cancel, Qt::AlignCenter, "Cancel");
+
+    painter->restore();
+}
+
+bool ReservationCardDelegate::editorEvent(QEvent *event, QAbstractItemModel *model,
+                                          const QStyleOptionViewItem &option, const QModelIndex &index)
+{
+    if (event->type() == QEvent::MouseButtonRelease) {
+        QMouseEvent *mouse = static_cast<QMouseEvent *>(event);
+        if (mouse->button() == Qt::LeftButton
+            && cancelRect(option.rect).contains(mouse->position().toPoint())) {
+            emit cancelClicked(index);
+            return true;
+        }
+    }
+    return QStyledItemDelegate::editorEvent(event, model, option, index);
+}
@@ -0,0 +1,79 @@
+#ifndef RESERVATIONLISTMODEL_H
+#define RESERVATIONLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QDateTime>
+#include <QStyledItemDelegate>
+#include <QVector>
+
+#include "reservationtypes.h"
+
+struct ReservationRow
+{
+    TableId table = -1;
+    QString tableName;
+    QDateTime time;
+    bool isVIP = false;
+};
+
+// Reservation list for the dashboard. Rows arrive a page at a time: when the
+// view scrolls near the end, fetchMore asks for the next page through
+// fetchRequested and the owner appends it once it is ready. Opening the page
+// costs one page no matter how many reservations exist.
+class ReservationListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Role {
+        TableIdRole = Qt::UserRole + 1,
+        TableNameRole,
+        TimeRole,
+        VIPRole,
+    };
+
+    explicit ReservationListModel(QObject *parent = nullptr);
+
+    // Empties the list; the owner then starts appending the first page
+    void reset();
+    void appendRows(const QVector<ReservationRow> &page, bool more);
+    const ReservationRow &row(int index) const { return rows[index]; }
+    void removeReservation(int index);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+signals:
+    void fetchRequested();
+
+private:
+    QVector<ReservationRow> rows;
+    bool more = false;
+    bool fetching = false;
+};
+
+// Paints a reservation row as a card with a Cancel button. Nothing is a
+// real widget, so only rows inside the viewport cost anything.
+class ReservationCardDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    using QStyledItemDelegate::QStyledItemDelegate;
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+    bool editorEvent(QEvent *event, QAbstractItemModel *model,
+                     const QStyleOptionViewItem &option, const QModelIndex &index) override;
+
+signals:
+    void cancelClicked(const QModelIndex &index);
+
+private:
+    static QRect cardRect(const QRect &itemRect);
+    static QRect cancelRect(const QRect &itemRect);
+};
+
+#endif // RESERVATIONLISTMODEL_H
@@ -0,0 +1,125 @@
+#include "reservationquery.h"
+
+#include <QDebug>
+#include <QSqlError>
+
+#include <algorithm>
+
+#include "statementcache.h"
+
+ReservationQuery &ReservationQuery::forUser(const QString &username)
+{
+    this->username = username;
+    return *this;
+}
+
+ReservationQuery &ReservationQuery::between(EpochSeconds from, EpochSeconds to)
+{
+    this->from = std::max(this->from, from);
+    this->to = std::min(this->to, to);
+    return *this;
+}
+
+ReservationQuery &ReservationQuery::onTables(const QStringList &tableIds)
+{
+    this->tableIds = tableIds;
+    return *this;
+}
+
+ReservationQuery &ReservationQuery::ascending(bool ascending)
+{
+    isAscending = ascending;
+    return *this;
+}
+
+QString ReservationQuery::sql() const
+{
+    QStringList where;
+    if (username)
+        where << "username = :username";
+    if (from != std::numeric_limits<EpochSeconds>::min())
+        where << "reservation_time >= :from";
+    if (to != std::numeric_limits<EpochSeconds>::max())
+        where << "reservation_time < :to";
+    if (tableIds) {
+        if (tableIds->isEmpty()) {
+            where << "0";
+        } else {
+            QStringList placeholders;
+            for (int i = 0; i < tableIds->size(); ++i)
+                placeholders << QString(":table%1").arg(i);
+            where << "table_id IN (" + placeholders.join(", ") + ")";
+        }
+    }
+
+    QString sql = "SELECT table_id, reservation_time FROM reservations";
+    if (!where.isEmpty())
+        sql += " WHERE " + where.join(" AND ");
+    sql += QString(" ORDER BY reservation_time %1 LIMIT :limit OFFSET :offset")
+               .arg(isAscending ? "ASC" : "DESC");
+    return sql;
+}
+
+QSqlQuery *ReservationQuery::exec(int limit, int offset, const QString &connectionName) const
+{
+    QSqlQuery &query = StatementCache::statement(sql(), connectionName);
+
+    if (username)
+        query.bindValue(":username", *username);
+    if (from != std::numeric_limits<EpochSeconds>::min())
+        query.bindValue(":from", qint64(from));
+    if (to != std::numeric_limits<EpochSeconds>::max())
+        query.bindValue(":to", qint64(to));
+    if (tableIds) {
+        for (int i = 0; i < tableIds->size(); ++i)
+            query.bindValue(QString(":table%1").arg(i), tableIds->at(i));
+    }
+    query.bindValue(":limit", limit);
+    query.bindValue(":offset", offset);
+    if (!query.exec()) {
+        qDebug() << "Failed to load reservations:" << query.lastError().text();
+        return nullptr;
+    }
+    return &query;
+}
+
+ReservationPager::ReservationPager(const ReservationQuery &query, int pageSize, const QString &connectionName)
+    : query(query)
+    , connectionName(connectionName)
+    , pageSize(pageSize)
+{}
+
+bool ReservationPager::fetchPage()
+{
+    cursor = query.exec(pageSize, offset, connectionName);
+    if (!cursor) {
+        lastPage = true;
+        return false;
+    }
+    started = true;
+    rowsInPage = 0;
+    return true;
+}
+
+bool ReservationPager::next(QString &tableId, EpochSeconds &time)
+{
+    if (!started && !fetchPage())
+        return false;
+
+    while (!cursor->next()) {
+        // A short page means there is nothing after it
+        if (lastPage || rowsInPage < pageSize) {
+            lastPage = true;
+            cursor->finish();
+            return false;
+        }
+        if (!fetchPage())
+            return false;
+    }
+
+    ++rowsInPage;
+    ++offset;
+    tableId = cursor->value(0).toString();
+    time = cursor->value(1).toLongLong();
+    return true;
+}
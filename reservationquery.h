@@ -0,0 +1,63 @@
+#ifndef RESERVATIONQUERY_H
+#define RESERVATIONQUERY_H
+
+#include <QSqlQuery>
+#include <QStringList>
+
+#include <limits>
+#include <optional>
+
+#include "reservationtypes.h"
+
+// Typed builder for the dashboard's reservation list. Every filter becomes
+// a bound parameter in the WHERE clause so SQLite can answer it with an
+// index range scan instead of shipping every row across to C++.
+class ReservationQuery
+{
+public:
+    ReservationQuery &forUser(const QString &username);
+    // Keeps reservations starting in [from, to); repeated calls intersect
+    ReservationQuery &between(EpochSeconds from, EpochSeconds to);
+    // Keeps reservations on these tables only; an empty list matches nothing
+    ReservationQuery &onTables(const QStringList &tableIds);
+    ReservationQuery &ascending(bool ascending);
+
+    // LIMIT and OFFSET are bound too, so paging reuses one cached statement
+    QString sql() const;
+    // Runs one page on a cached statement; nullptr if it failed
+    QSqlQuery *exec(int limit, int offset, const QString &connectionName) const;
+
+private:
+    std::optional<QString> username;
+    std::optional<QStringList> tableIds;
+    EpochSeconds from = std::numeric_limits<EpochSeconds>::min();
+    EpochSeconds to = std::numeric_limits<EpochSeconds>::max();
+    bool isAscending = true;
+};
+
+// Walks a ReservationQuery one LIMIT/OFFSET page at a time
+class ReservationPager
+{
+public:
+    ReservationPager(const ReservationQuery &query, int pageSize,
+                     const QString &connectionName = QLatin1String(QSqlDatabase::defaultConnection));
+
+    // False once the last page is exhausted or a query fails
+    bool next(QString &tableId, EpochSeconds &time);
+    // A row already returned was deleted, so later pages start one earlier
+    void rowRemoved() { --offset; }
+
+private:
+    bool fetchPage();
+
+    ReservationQuery query;
+    QString connectionName;
+    QSqlQuery *cursor = nullptr;
+    int pageSize;
+    int offset = 0;
+    int rowsInPage = 0;
+    bool started = false;
+    bool lastPage = false;
+};
+
+#endif // RESERVATIONQUERY_H
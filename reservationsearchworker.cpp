@@ -0,0 +1,85 @@
+#include "reservationsearchworker.h"
+
+#include <QDebug>
+#include <QSqlError>
+
+#include "reservationdatabase.h"
+#include "statementcache.h"
+
+ReservationSearchWorker::ReservationSearchWorker(int pageSize, QObject *parent)
+    : QObject(parent)
+    , pageSize(pageSize)
+    , connectionName(QString("reservation-search-%1").arg(quintptr(this), 0, 16))
+{}
+
+ReservationSearchWorker::~ReservationSearchWorker()
+{
+    // The pager's statements have to go before their connection
+    pager.reset();
+    StatementCache::clear(connectionName);
+    if (QSqlDatabase::contains(connectionName)) {
+        QSqlDatabase::database(connectionName, false).close();
+        QSqlDatabase::removeDatabase(connectionName);
+    }
+}
+
+bool ReservationSearchWorker::openConnection()
+{
+    // Connections belong to the thread that opens them, so this is cloned
+    // lazily from the GUI connection on the first search
+    if (QSqlDatabase::contains(connectionName))
+        return true;
+
+    QSqlDatabase db = QSqlDatabase::cloneDatabase(QSqlDatabase::defaultConnection, connectionName);
+    if (!db.open()) {
+        qDebug() << "Could not open the reservation search connection:" << db.lastError().text();
+        return false;
+    }
+    return ReservationDatabase::configure(db);
+}
+
+void ReservationSearchWorker::start(quint64 generation, const ReservationQuery &query)
+{
+    if (superseded(generation))
+        return;
+
+    current = generation;
+    openConnection();
+    pager = std::make_unique<ReservationPager>(query, pageSize, connectionName);
+    fetchMore(generation);
+}
+
+void ReservationSearchWorker::fetchMore(quint64 generation)
+{
+    if (generation != current || !pager)
+        return;
+
+    QVector<ReservationHit> hits;
+    hits.reserve(pageSize);
+    ReservationHit hit;
+    bool more = true;
+    while (hits.size() < pageSize) {
+        // A newer search is waiting in the queue; stop reading this one
+        if (superseded(generation)) {
+            pager.reset();
+            return;
+        }
+        if (!pager->next(hit.tableId, hit.time)) {
+            more = false;
+            break;
+        }
+        hits.append(hit);
+    }
+
+    if (!more) {
+        pager.reset();
+    }
+    emit pageReady(generation, hits, more);
+}
+
+void ReservationSearchWorker::rowRemoved(quint64 generation)
+{
+    if (generation == current && pager) {
+        pager->rowRemoved();
+    }
+}
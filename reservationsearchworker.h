@@ -0,0 +1,56 @@
+#ifndef RESERVATIONSEARCHWORKER_H
+#define RESERVATIONSEARCHWORKER_H
+
+#include <QObject>
+#include <QVector>
+
+#include <atomic>
+#include <memory>
+
+#include "reservationquery.h"
+
+struct ReservationHit
+{
+    QString tableId;
+    EpochSeconds time;
+};
+
+// Runs dashboard reservation searches on its own thread and its own
+// QSqlDatabase connection, so typing in the search box never waits on
+// SQLite. Each search carries a generation number; starting a newer one
+// makes older searches stop at the next row and their pages are dropped.
+// Pages come back through pageReady, queued to the owner's thread.
+class ReservationSearchWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ReservationSearchWorker(int pageSize, QObject *parent = nullptr);
+    ~ReservationSearchWorker() override;
+
+    // Thread-safe: marks every search older than `generation` as superseded.
+    // Call before queueing start() for that generation.
+    void supersede(quint64 generation) { latest.store(generation); }
+
+    // Must run on the worker thread (queue them with QMetaObject::invokeMethod)
+    void start(quint64 generation, const ReservationQuery &query);
+    void fetchMore(quint64 generation);
+    void rowRemoved(quint64 generation);
+
+signals:
+    void pageReady(quint64 generation, const QVector<ReservationHit> &hits, bool more);
+
+private:
+    bool superseded(quint64 generation) const { return generation != latest.load(); }
+    bool openConnection();
+
+    const int pageSize;
+    std::atomic<quint64> latest{0};
+    quint64 current = 0;
+    std::unique_ptr<ReservationPager> pager;
+    QString connectionName;
+};
+
+Q_DECLARE_METATYPE(ReservationHit)
+
+#endif // RESERVATIONSEARCHWORKER_H
@@ -0,0 +1,285 @@
+#include "reservationservice.h"
+
+#include <ctime>
+#include <mutex>
+#include <utility>
+
+// Seconds the server's local time is ahead of UTC at `time`, for the
+// engine's day grid. Request threads call this concurrently, hence the
+// reentrant conversions.
+static int localUtcOffset(EpochSeconds time)
+{
+    std::time_t at = static_cast<std::time_t>(time);
+    std::tm local;
+    std::tm utc;
+#ifdef _WIN32
+    localtime_s(&local, &at);
+    gmtime_s(&utc, &at);
+#else
+    localtime_r(&at, &local);
+    gmtime_r(&at, &utc);
+#endif
+    utc.tm_isdst = local.tm_isdst;
+    return static_cast<int>(std::difftime(std::mktime(&local), std::mktime(&utc)));
+}
+
+// Start of the 30 minute slot a reservation falls in, see SlotGrid::kSlotSeconds
+#define SLOT_START_SQL "(reservation_time - reservation_time % 1800)"
+static_assert(SlotGrid::kSlotSeconds == 1800, "SLOT_START_SQL assumes 30 minute slots");
+
+// Tables created before the uniqueness guarantee lack slot_start. Rows that
+// already share a slot keep the earliest booking.
+static bool addSlotColumn(SqliteConnection &db)
+{
+    sqlite3_stmt *probe = nullptr;
+    int rc = sqlite3_prepare_v2(db.handle(), "SELECT slot_start FROM reservations", -1, &probe, nullptr);
+    sqlite3_finalize(probe);
+    if (rc == SQLITE_OK)
+        return true;
+
+    return db.exec("ALTER TABLE reservations ADD COLUMN slot_start INTEGER "
+                   "GENERATED ALWAYS AS " SLOT_START_SQL " VIRTUAL")
+        && db.exec("DELETE FROM reservations WHERE rowid NOT IN "
+                   "(SELECT MIN(rowid) FROM reservations GROUP BY table_id, slot_start)");
+}
+
+ReservationService::ReservationService(const std::string &path, GroupCommitWriter &writer)
+    : path(path)
+    , writer(writer)
+    , watcher(path)
+{}
+
+bool ReservationService::load()
+{
+    // Run on the writer's connection: it was opened before these tables
+    // and indexes existed, and would not see them for the upsert otherwise
+    bool created = writer.run([](SqliteConnection &db) {
+        return db.exec("CREATE TABLE IF NOT EXISTS reservations ("
+                       "table_id TEXT NOT NULL, "
+                       "reservation_time INTEGER NOT NULL, "
+                       "username TEXT NOT NULL, "
+                       "slot_start INTEGER GENERATED ALWAYS AS " SLOT_START_SQL " VIRTUAL)")
+            && addSlotColumn(db)
+            && db.exec("CREATE INDEX IF NOT EXISTS reservations_by_user "
+                       "ON reservations (username, reservation_time, table_id)")
+            && db.exec("CREATE INDEX IF NOT EXISTS reservations_by_table "
+                       "ON reservations (table_id, reservation_time)")
+            && db.exec("CREATE INDEX IF NOT EXISTS reservations_by_time "
+                       "ON reservations (reservation_time, table_id)")
+            && db.exec("CREATE UNIQUE INDEX IF NOT EXISTS reservations_slot "
+                       "ON reservations (table_id, slot_start)");
+    });
+    if (!created)
+        return false;
+
+    {
+        std::unique_lock<std::shared_mutex> guard(lock);
+        engine.setUtcOffset(localUtcOffset);
+
+        // Same floor plan as Home::setupTables: Table1..Table12 seat 4,
+        // Table13 and Table14 are the 8 seat VIP tables
+        for (int i = 1; i <= 14; ++i) {
+            engine.addTable("Table" + std::to_string(i), i >= 13 ? 8 : 4, i >= 13);
+        }
+    }
+    return refresh();
+}
+
+bool ReservationService::refresh()
+{
+    std::lock_guard<std::mutex> sync(syncLock);
+
+    // data_version changes whenever another connection commits: the
+    // writer's, a request thread's or a host stand's
+    std::int64_t version;
+    {
+        StatementLease stmt(watcher, "PRAGMA data_version");
+        if (!stmt || stmt.step() != SQLITE_ROW)
+            return false;
+        version = stmt.integer(0);
+    }
+    if (version == seenVersion)
+        return true;
+
+    // Read before taking the engine lock, so queries go on meanwhile. A
+    // commit landing after the version was read triggers another reload.
+    std::vector<std::pair<std::string, EpochSeconds>> rows;
+    {
+        StatementLease stmt(watcher, "SELECT table_id, reservation_time FROM reservations");
+        if (!stmt)
+            return false;
+        int rc;
+        while ((rc = stmt.step()) == SQLITE_ROW) {
+            rows.emplace_back(stmt.text(0), stmt.integer(1));
+        }
+        if (rc != SQLITE_DONE)
+            return false;
+    }
+
+    std::unique_lock<std::shared_mutex> guard(lock);
+    engine.clearReservations();
+    for (const auto &row : rows) {
+        TableId id = engine.tableId(row.first);
+        if (id >= 0) {
+            engine.restore(id, row.second);
+        }
+    }
+    seenVersion = version;
+    return true;
+}
+
+ReservationService::Result ReservationService::reserve(const std::string &table, EpochSeconds start,
+                                                       const std::string &username,
+                                                       EpochSeconds *conflictingSlot)
+{
+    // A failed reload leaves the rows as last read; the insert still decides
+    refresh();
+
+    EpochSeconds length;
+    {
+        std::shared_lock<std::shared_mutex> guard(lock);
+        TableId id = engine.tableId(table);
+        if (id < 0)
+            return Result::UnknownTable;
+        length = engine.sittingFor(id);
+        const auto clashes = engine.overlapping(id, start, start + length);
+        if (!clashes.empty()) {
+            if (conflictingSlot)
+                *conflictingSlot = clashes.front().first;
+            return Result::Conflict;
+        }
+    }
+
+    // The insert settles races with other requests and with the host
+    // stands: every booking on a table lasts its sitting, so any row
+    // starting less than `length` away overlaps, and the insert then
+    // changes no rows and the booking is refused outright. The engine
+    // picks the new row up on its next refresh.
+    bool taken = false;
+    EpochSeconds holder = start;
+    bool stored = writer.run([&](SqliteConnection &db) {
+        StatementLease stmt(db, "INSERT INTO reservations (table_id, reservation_time, username) "
+                                "SELECT ?1, ?2, ?3 WHERE NOT EXISTS "
+                                "(SELECT 1 FROM reservations WHERE table_id = ?1 "
+                                " AND reservation_time > ?2 - ?4 AND reservation_time < ?2 + ?4) "
+                                "ON CONFLICT (table_id, slot_start) DO NOTHING");
+        if (!stmt)
+            return false;
+        stmt.bind(1, table);
+        stmt.bind(2, std::int64_t(start));
+        stmt.bind(3, username);
+        stmt.bind(4, std::int64_t(length));
+        if (stmt.step() != SQLITE_DONE)
+            return false;
+        taken = sqlite3_changes(db.handle()) == 0;
+        if (!taken)
+            return true;
+
+        StatementLease existing(db, "SELECT reservation_time FROM reservations WHERE table_id = ?1 "
+                                    "AND reservation_time > ?2 - ?3 AND reservation_time < ?2 + ?3 "
+                                    "ORDER BY reservation_time LIMIT 1");
+        if (existing) {
+            existing.bind(1, table);
+            existing.bind(2, std::int64_t(start));
+            existing.bind(3, std::int64_t(length));
+            if (existing.step() == SQLITE_ROW)
+                holder = existing.integer(0);
+        }
+        return true;
+    });
+
+    if (!stored)
+        return Result::StorageError;
+    if (taken) {
+        if (conflictingSlot)
+            *conflictingSlot = holder;
+        return Result::Conflict;
+    }
+    return Result::Ok;
+}
+
+ReservationService::Result ReservationService::cancel(const std::string &table, EpochSeconds start)
+{
+    {
+        std::shared_lock<std::shared_mutex> guard(lock);
+        if (engine.tableId(table) < 0)
+            return Result::UnknownTable;
+    }
+
+    // Whether the row exists is the database's answer, not the engine's,
+    // so bookings made at a host stand can be cancelled too
+    bool found = false;
+    bool removed = writer.run([&](SqliteConnection &db) {
+        StatementLease stmt(db, "DELETE FROM reservations WHERE table_id = ? AND reservation_time = ?");
+        if (!stmt)
+            return false;
+        stmt.bind(1, table);
+        stmt.bind(2, std::int64_t(start));
+        if (stmt.step() != SQLITE_DONE)
+            return false;
+        found = sqlite3_changes(db.handle()) > 0;
+        return true;
+    });
+    if (!removed)
+        return Result::StorageError;
+    return found ? Result::Ok : Result::NotFound;
+}
+
+std::vector<ServiceReservation> ReservationService::list(EpochSeconds from, EpochSeconds to,
+                                                         const std::string &username,
+                                                         const std::string &table, int limit) const
+{
+    // Each filter shape has its own SQL, so every variant stays a cached
+    // statement that the covering indexes can answer
+    std::string sql = "SELECT table_id, reservation_time, username FROM reservations "
+                      "WHERE reservation_time >= ? AND reservation_time < ?";
+    if (!username.empty())
+        sql += " AND username = ?";
+    if (!table.empty())
+        sql += " AND table_id = ?";
+    sql += " ORDER BY reservation_time LIMIT ?";
+
+    std::vector<ServiceReservation> reservations;
+    StatementLease stmt(SqliteConnection::forThread(path), sql);
+    if (!stmt)
+        return reservations;
+
+    int index = 1;
+    stmt.bind(index++, std::int64_t(from));
+    stmt.bind(index++, std::int64_t(to));
+    if (!username.empty())
+        stmt.bind(index++, username);
+    if (!table.empty())
+        stmt.bind(index++, table);
+    stmt.bind(index++, std::int64_t(limit));
+
+    while (stmt.step() == SQLITE_ROW) {
+        reservations.push_back({stmt.text(0), stmt.integer(1), stmt.text(2)});
+    }
+    return reservations;
+}
+
+std::vector<EngineTable> ReservationService::available(EpochSeconds start, EpochSeconds end, int party)
+{
+    refresh();
+    std::shared_lock<std::shared_mutex> guard(lock);
+
+    std::vector<EngineTable> tables;
+    for (TableId id : engine.findFreeTables(start, end, party)) {
+        tables.push_back(engine.table(id));
+    }
+    return tables;
+}
+
+std::vector<EngineTable> ReservationService::available(EpochSeconds start, int party)
+{
+    refresh();
+    std::shared_lock<std::shared_mutex> guard(lock);
+
+    std::vector<EngineTable> tables;
+    for (TableId id : engine.tablesWithSeats(party)) {
+        if (engine.isFree(id, start))
+            tables.push_back(engine.table(id));
+    }
+    return tables;
+}
@@ -0,0 +1,75 @@
+#ifndef RESERVATIONSERVICE_H
+#define RESERVATIONSERVICE_H
+
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include "reservationengine.h"
+#include "serverdatabase.h"
+
+struct ServiceReservation
+{
+    std::string table;
+    EpochSeconds start;
+    std::string username;
+};
+
+// Server-side reservations for the REST endpoints. The server opens the
+// desktop client's testdb.db, and that database is the source of truth:
+// inserts refuse overlapping rows and deletes report what they removed, so
+// the API and the host stands can book concurrently. A ReservationEngine
+// applies the same conflict rules as Home::on_Reserve_clicked to answer
+// availability quickly. It is a cache of the rows, reloaded whenever
+// PRAGMA data_version shows another connection committed, and sits
+// behind a reader/writer lock so queries run in parallel.
+class ReservationService
+{
+public:
+    enum class Result {
+        Ok,
+        UnknownTable,
+        Conflict,
+        NotFound,
+        StorageError,
+    };
+
+    ReservationService(const std::string &path, GroupCommitWriter &writer);
+
+    // Creates the schema, registers the floor plan and loads every booking
+    bool load();
+
+    // On Conflict, `conflictingSlot` receives the start of the booking in the way
+    Result reserve(const std::string &table, EpochSeconds start, const std::string &username,
+                   EpochSeconds *conflictingSlot = nullptr);
+    Result cancel(const std::string &table, EpochSeconds start);
+
+    // Reservations starting in [from, to), optionally for one user or table
+    std::vector<ServiceReservation> list(EpochSeconds from, EpochSeconds to,
+                                         const std::string &username, const std::string &table,
+                                         int limit) const;
+
+    // Free tables seating at least `party` for the whole of [start, end)
+    std::vector<EngineTable> available(EpochSeconds start, EpochSeconds end, int party);
+    // Free tables seating at least `party` for their own sitting from
+    // `start`, the same check reserve() makes
+    std::vector<EngineTable> available(EpochSeconds start, int party);
+
+private:
+    // Reloads the engine if the database changed since the last look
+    bool refresh();
+
+    const std::string path;
+    GroupCommitWriter &writer;
+
+    std::mutex syncLock;
+    SqliteConnection watcher;  // Only used under syncLock
+    std::int64_t seenVersion = -1;
+
+    std::shared_mutex lock;
+    ReservationEngine engine;
+};
+
+#endif // RESERVATIONSERVICE_H
@@ -0,0 +1,170 @@
+#include "reservationsnapshot.h"
+
+#include <QSaveFile>
+
+#include <cstring>
+
+static const char kMagic[8] = {'R', 'S', 'V', 'S', 'N', 'A', 'P', 0};
+
+struct ReservationSnapshot::Header
+{
+    char magic[8];
+    quint32_le version;
+    quint32_le tableCount;
+};
+
+struct ReservationSnapshot::Entry
+{
+    quint32_le nameOffset;      // Into the string pool
+    quint32_le nameLength;
+    quint32_le customerOffset;
+    quint32_le customerLength;
+    qint32_le seats;
+    quint32_le flags;
+    qint64_le reservationTime;
+    quint64_le timesOffset;     // From the start of the file, 8 byte aligned
+    quint32_le timeCount;
+    quint32_le padding;
+};
+
+enum EntryFlag : quint32 {
+    VIPFlag = 0x1,
+    ReservedFlag = 0x2,
+    OutOfServiceFlag = 0x4,
+};
+
+bool ReservationSnapshot::open(const QString &path)
+{
+    static_assert(sizeof(Header) == 16, "snapshot header layout");
+    static_assert(sizeof(Entry) == 48, "snapshot entry layout");
+
+    close();
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    size = file.size();
+    if (size < qint64(sizeof(Header))) {
+        close();
+        return false;
+    }
+
+    data = file.map(0, size);
+    if (!data) {
+        close();
+        return false;
+    }
+
+    const Header *header = reinterpret_cast<const Header *>(data);
+    if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0
+        || header->version != kVersion
+        || qint64(sizeof(Header)) + qint64(header->tableCount) * qint64(sizeof(Entry)) > size) {
+        close();
+        return false;
+    }
+
+    // Bounds are checked once here so table() can index blindly
+    const Entry *entries = reinterpret_cast<const Entry *>(data + sizeof(Header));
+    for (quint32 i = 0; i < header->tableCount; ++i) {
+        const Entry &entry = entries[i];
+        quint64 timesEnd = entry.timesOffset + quint64(entry.timeCount) * sizeof(qint64);
+        if (entry.timesOffset % alignof(qint64) != 0 || timesEnd > quint64(size)
+            || quint64(entry.nameOffset) + entry.nameLength > quint64(size)
+            || quint64(entry.customerOffset) + entry.customerLength > quint64(size)) {
+            close();
+            return false;
+        }
+    }
+
+    count = int(header->tableCount);
+    return true;
+}
+
+void ReservationSnapshot::close()
+{
+    if (data) {
+        file.unmap(const_cast<uchar *>(data));
+    }
+    data = nullptr;
+    size = 0;
+    count = 0;
+    file.close();
+}
+
+QString ReservationSnapshot::string(quint32 offset, quint32 length) const
+{
+    return QString::fromUtf8(reinterpret_cast<const char *>(data + offset), int(length));
+}
+
+ReservationSnapshot::Table ReservationSnapshot::table(int index) const
+{
+    const Entry &entry = reinterpret_cast<const Entry *>(data + sizeof(Header))[index];
+
+    Table table;
+    table.name = string(entry.nameOffset, entry.nameLength);
+    table.seats = entry.seats;
+    table.isVIP = entry.flags & VIPFlag;
+    table.isReserved = entry.flags & ReservedFlag;
+    table.inService = !(entry.flags & OutOfServiceFlag);
+    table.reservationTime = entry.reservationTime;
+    table.customerName = string(entry.customerOffset, entry.customerLength);
+    table.times = reinterpret_cast<const qint64_le *>(data + entry.timesOffset);
+    table.timeCount = int(entry.timeCount);
+    return table;
+}
+
+bool ReservationSnapshot::write(const QString &path, const QVector<TableSource> &tables)
+{
+    // Lay out the string pool after the directory, then the time arrays
+    QByteArray strings;
+    QVector<Entry> entries(tables.size());
+    const quint64 poolStart = sizeof(Header) + quint64(tables.size()) * sizeof(Entry);
+    for (int i = 0; i < tables.size(); ++i) {
+        const QByteArray name = tables[i].name.toUtf8();
+        const QByteArray customer = tables[i].customerName.toUtf8();
+        Entry &entry = entries[i];
+        std::memset(&entry, 0, sizeof(entry));
+        entry.nameOffset = quint32(poolStart + strings.size());
+        entry.nameLength = quint32(name.size());
+        strings.append(name);
+        entry.customerOffset = quint32(poolStart + strings.size());
+        entry.customerLength = quint32(customer.size());
+        strings.append(customer);
+        entry.seats = tables[i].seats;
+        entry.flags = (tables[i].isVIP ? VIPFlag : 0) | (tables[i].isReserved ? ReservedFlag : 0)
+                      | (tables[i].inService ? 0 : OutOfServiceFlag);
+        entry.reservationTime = tables[i].reservationTime;
+    }
+
+    quint64 timesOffset = poolStart + strings.size();
+    const int alignPadding = int((alignof(qint64) - timesOffset % alignof(qint64)) % alignof(qint64));
+    strings.append(QByteArray(alignPadding, '\0'));
+    timesOffset += alignPadding;
+
+    QByteArray times;
+    for (int i = 0; i < tables.size(); ++i) {
+        entries[i].timesOffset = timesOffset + times.size();
+        entries[i].timeCount = quint32(tables[i].times.size());
+        for (EpochSeconds time : tables[i].times) {
+            char bytes[sizeof(qint64)];
+            qToLittleEndian<qint64>(time, bytes);
+            times.append(bytes, sizeof(bytes));
+        }
+    }
+
+    Header header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.tableCount = quint32(tables.size());
+
+    QSaveFile out(path);
+    if (!out.open(QIODevice::WriteOnly))
+        return false;
+
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(entries.constData()), entries.size() * sizeof(Entry));
+    out.write(strings);
+    out.write(times);
+    return out.commit();
+}
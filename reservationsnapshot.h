@@ -0,0 +1,76 @@
+#ifndef RESERVATIONSNAPSHOT_H
+#define RESERVATIONSNAPSHOT_H
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <QtEndian>
+
+#include "reservationtypes.h"
+
+// Versioned binary snapshot of every table and its reserved start times.
+// The file is memory mapped and read in place: a fixed header, one fixed
+// directory entry per table, a UTF-8 string pool and sorted little endian
+// int64 epoch arrays. Opening it parses nothing, so startup no longer pays
+// for JSON and ISO date parsing. reservations.json is still read once as an
+// import when no snapshot exists yet.
+class ReservationSnapshot
+{
+public:
+    static constexpr quint32 kVersion = 1;
+    static constexpr EpochSeconds kNoTime = INT64_MIN;
+
+    struct Table
+    {
+        QString name;
+        int seats = 0;
+        bool isVIP = false;
+        bool isReserved = false;
+        bool inService = true;  // Older snapshots have every table in service
+        EpochSeconds reservationTime = kNoTime;
+        QString customerName;
+        const qint64_le *times = nullptr;  // Sorted, points into the mapping
+        int timeCount = 0;
+    };
+
+    // What write() needs per table; times must be sorted
+    struct TableSource
+    {
+        QString name;
+        int seats;
+        bool isVIP;
+        bool isReserved;
+        bool inService;
+        EpochSeconds reservationTime;
+        QString customerName;
+        QVector<EpochSeconds> times;
+    };
+
+    ReservationSnapshot() = default;
+    ~ReservationSnapshot() { close(); }
+    ReservationSnapshot(const ReservationSnapshot &) = delete;
+    ReservationSnapshot &operator=(const ReservationSnapshot &) = delete;
+
+    // Maps and validates the file; false if missing, truncated or another version
+    bool open(const QString &path);
+    void close();
+
+    int tableCount() const { return count; }
+    Table table(int index) const;
+
+    // Written to a temporary file and renamed over `path`
+    static bool write(const QString &path, const QVector<TableSource> &tables);
+
+private:
+    struct Header;
+    struct Entry;
+
+    QString string(quint32 offset, quint32 length) const;
+
+    QFile file;
+    const uchar *data = nullptr;
+    qint64 size = 0;
+    int count = 0;
+};
+
+#endif // RESERVATIONSNAPSHOT_H
@@ -0,0 +1,11 @@
+#ifndef RESERVATIONTYPES_H
+#define RESERVATIONTYPES_H
+
+#include <cstdint>
+
+// Shared by the engine headers. Times are seconds since the Unix epoch and
+// tables are dense indices handed out by ReservationEngine::addTable.
+using EpochSeconds = std::int64_t;
+using TableId = int;
+
+#endif // RESERVATIONTYPES_H
@@ -0,0 +1,79 @@
+#include "reservationwritequeue.h"
+
+#include <QDebug>
+#include <QSqlError>
+#include <QSqlQuery>
+
+ReservationWriteQueue::ReservationWriteQueue(QObject *parent, const QString &connectionName)
+    : QObject(parent)
+    , connectionName(connectionName)
+{
+    window.setSingleShot(true);
+    window.setInterval(kWindowMs);
+    connect(&window, &QTimer::timeout, this, &ReservationWriteQueue::flush);
+}
+
+ReservationWriteQueue::~ReservationWriteQueue()
+{
+    // Owners are usually half destroyed by now, so the writes still land
+    // but nobody is called back
+    for (Pending &write : pending) {
+        write.done = nullptr;
+    }
+    flush();
+}
+
+void ReservationWriteQueue::enqueue(Write write, Done done)
+{
+    pending.append({std::move(write), std::move(done)});
+    if (pending.size() >= kMaxBatch) {
+        flush();
+    } else if (!window.isActive()) {
+        window.start();
+    }
+}
+
+void ReservationWriteQueue::flush()
+{
+    window.stop();
+    if (pending.isEmpty())
+        return;
+
+    // Callbacks may enqueue again, so work on a detached batch
+    QVector<Pending> batch;
+    batch.swap(pending);
+
+    QSqlDatabase db = QSqlDatabase::database(connectionName);
+    const bool inTransaction = db.transaction();
+    if (!inTransaction) {
+        qDebug() << "Could not start a write batch, writing rows one by one:" << db.lastError().text();
+    }
+
+    // A failed write only rolls back itself; the rest of the batch stands
+    QSqlQuery savepoint(db);
+    QVector<bool> results;
+    results.reserve(batch.size());
+    for (const Pending &write : batch) {
+        const bool scoped = savepoint.exec("SAVEPOINT reservation_write");
+        const bool ok = write.write();
+        if (scoped && !ok) {
+            savepoint.exec("ROLLBACK TO reservation_write");
+        }
+        if (scoped) {
+            savepoint.exec("RELEASE reservation_write");
+        }
+        results.append(ok);
+    }
+
+    if (inTransaction && !db.commit()) {
+        qDebug() << "Failed to commit reservation writes:" << db.lastError().text();
+        db.rollback();
+        results.fill(false);
+    }
+
+    for (int i = 0; i < batch.size(); ++i) {
+        if (batch[i].done) {
+            batch[i].done(results[i]);
+        }
+    }
+}
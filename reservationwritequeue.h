@@ -0,0 +1,49 @@
+#ifndef RESERVATIONWRITEQUEUE_H
+#define RESERVATIONWRITEQUEUE_H
+
+#include <QObject>
+#include <QSqlDatabase>
+#include <QTimer>
+#include <QVector>
+
+#include <functional>
+
+// Write-behind queue for reservation inserts and deletes. Writes arriving
+// within a few milliseconds of each other are applied in one BEGIN/COMMIT,
+// so a rush of bookings costs one fsync per batch instead of one per row.
+// Each write runs under its own savepoint, so a write of several statements
+// that reports failure leaves nothing behind. Every write still gets its
+// own completion callback: true only if it succeeded and the batch committed.
+class ReservationWriteQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Runs one write on the connection and reports whether it succeeded
+    using Write = std::function<bool()>;
+    using Done = std::function<void(bool ok)>;
+
+    static constexpr int kWindowMs = 5;
+    static constexpr int kMaxBatch = 128;
+
+    explicit ReservationWriteQueue(QObject *parent = nullptr,
+                                   const QString &connectionName = QLatin1String(QSqlDatabase::defaultConnection));
+    ~ReservationWriteQueue() override;
+
+    void enqueue(Write write, Done done);
+    // Applies everything queued so far right away
+    void flush();
+
+private:
+    struct Pending
+    {
+        Write write;
+        Done done;
+    };
+
+    QString connectionName;
+    QTimer window;
+    QVector<Pending> pending;
+};
+
+#endif // RESERVATIONWRITEQUEUE_H
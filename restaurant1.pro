@@ -14,12 +14,36 @@ SOURCES += \
     restaurant.cpp \
     usersignup.cpp \
     home.cpp \
+    floorplanrenderer.cpp \
+    floorplanview.cpp \
+    occupancycalendar.cpp \
+    reservationdatabase.cpp \
+    reservationjournal.cpp \
+    reservationlistmodel.cpp \
+    reservationquery.cpp \
+    reservationsearchworker.cpp \
+    reservationsnapshot.cpp \
+    reservationwritequeue.cpp \
+    statementcache.cpp \
+    tablestore.cpp \
 
 HEADERS += \
     loginscreen.h \
     restaurant.h \
     usersignup.h \
     home.h \
+    floorplanrenderer.h \
+    floorplanview.h \
+    occupancycalendar.h \
+    reservationdatabase.h \
+    reservationjournal.h \
+    reservationlistmodel.h \
+    reservationquery.h \
+    reservationsearchworker.h \
+    reservationsnapshot.h \
+    reservationwritequeue.h \
+    statementcache.h \
+    tablestore.h \
 
 FORMS += \
     loginscreen.ui \
@@ -27,6 +51,8 @@ FORMS += \
     usersignup.ui \
     home.ui
 
+include(reservationengine.pri)
+
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
@@ -1,26 +1,67 @@
 #include "crow_all.h"
 #include <sqlite3.h>
 
-void initializeDatabase() {
-    sqlite3 *db;
-    int rc = sqlite3_open("user_database.db", &db);
-    if (rc) {
-        std::cerr << "Can't open database: " << sqlite3_errmsg(db) << std::endl;
-        return;
+#include "reservationservice.h"
+#include "serverdatabase.h"
+
+#include <climits>
+
+static const char *const kDatabasePath = "user_database.db";
+// Reservations live in the desktop client's database, so the API and the
+// host stands book against one set of rows
+static const char *const kReservationDatabasePath = "testdb.db";
+static const long long kMaxParty = 1000;
+static const int kDefaultListLimit = 100;
+static const int kMaxListLimit = 1000;
+
+static crow::response message(int code, const std::string &text) {
+    crow::json::wvalue body;
+    body["message"] = text;
+    return crow::response(code, body);
+}
+
+static crow::response resultResponse(ReservationService::Result result, int okCode, const std::string &okText) {
+    switch (result) {
+    case ReservationService::Result::Ok:
+        return message(okCode, okText);
+    case ReservationService::Result::UnknownTable:
+        return message(404, "Unknown table");
+    case ReservationService::Result::Conflict:
+        return message(409, "This time slot is already reserved");
+    case ReservationService::Result::NotFound:
+        return message(404, "No such reservation");
+    case ReservationService::Result::StorageError:
+    default:
+        return message(500, "Could not save the change");
     }
+}
+
+// Integer query parameter, or `fallback` when it is missing or malformed
+static long long intParam(const crow::request &req, const char *name, long long fallback) {
+    const char *value = req.url_params.get(name);
+    if (!value) {
+        return fallback;
+    }
+    char *end = nullptr;
+    long long parsed = std::strtoll(value, &end, 10);
+    return (end && *end == '\0' && end != value) ? parsed : fallback;
+}
 
-    const char *sql = "CREATE TABLE IF NOT EXISTS users ("
-                      "username TEXT PRIMARY KEY, "
-                      "password TEXT NOT NULL, "
-                      "permission TEXT NOT NULL);";
-    char *errMsg = nullptr;
-    rc = sqlite3_exec(db, sql, nullptr, nullptr, &errMsg);
-    if (rc != SQLITE_OK) {
-        std::cerr << "SQL error: " << errMsg << std::endl;
-        sqlite3_free(errMsg);
+static std::string stringParam(const crow::request &req, const char *name) {
+    const char *value = req.url_params.get(name);
+    return value ? value : "";
+}
+
+void initializeDatabase() {
+    SqliteConnection &db = SqliteConnection::forThread(kDatabasePath);
+    if (!db.isOpen()) {
+        return;
     }
 
-    sqlite3_close(db);
+    db.exec("CREATE TABLE IF NOT EXISTS users ("
+            "username TEXT PRIMARY KEY, "
+            "password TEXT NOT NULL, "
+            "permission TEXT NOT NULL);");
 }
 
 int main() {
@@ -28,71 +69,165 @@ int main() {
 
     initializeDatabase();
 
-    CROW_ROUTE(app, "/create_user").methods("POST"_method)([](const crow::request& req) {
-        sqlite3 *db;
-        sqlite3_open("user_database.db", &db);
+    // Inserts from every request thread are group-committed by one writer
+    GroupCommitWriter writer(kDatabasePath);
 
+    CROW_ROUTE(app, "/create_user").methods("POST"_method)([&writer](const crow::request& req) {
         auto json = crow::json::load(req.body);
         std::string username = json["username"].s();
         std::string password = json["password"].s();
         std::string permission = json["permission"].s();
 
-        sqlite3_stmt *stmt;
-        const char *sql = "INSERT INTO users (username, password, permission) VALUES (?, ?, ?)";
-        sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-        sqlite3_bind_text(stmt, 1, username.c_str(), -1, SQLITE_STATIC);
-        sqlite3_bind_text(stmt, 2, password.c_str(), -1, SQLITE_STATIC);
-        sqlite3_bind_text(stmt, 3, permission.c_str(), -1, SQLITE_STATIC);
+        bool created = writer.run([&](SqliteConnection &db) {
+            StatementLease stmt(db, "INSERT INTO users (username, password, permission) VALUES (?, ?, ?)");
+            if (!stmt) {
+                return false;
+            }
+            stmt.bind(1, username);
+            stmt.bind(2, password);
+            stmt.bind(3, permission);
+            return stmt.step() == SQLITE_DONE;
+        });
 
-        int rc = sqlite3_step(stmt);
         crow::json::wvalue response;
-        if (rc == SQLITE_DONE) {
+        if (created) {
             response["message"] = "User created successfully";
-            sqlite3_finalize(stmt);
-            sqlite3_close(db);
             return crow::response(201, response);
         } else {
-            sqlite3_finalize(stmt);
-            sqlite3_close(db);
             return crow::response(500, "{\"message\":\"Error creating user\"}");
         }
     });
 
     CROW_ROUTE(app, "/login").methods("POST"_method)([](const crow::request& req) {
-        sqlite3 *db;
-        sqlite3_open("user_database.db", &db);
+        SqliteConnection &db = SqliteConnection::forThread(kDatabasePath);
 
         auto json = crow::json::load(req.body);
         std::string username = json["username"].s();
         std::string password = json["password"].s();
 
-        sqlite3_stmt *stmt;
-        const char *sql = "SELECT password, permission FROM users WHERE username = ?";
-        sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-        sqlite3_bind_text(stmt, 1, username.c_str(), -1, SQLITE_STATIC);
+        StatementLease stmt(db, "SELECT password, permission FROM users WHERE username = ?");
+        if (!stmt) {
+            return crow::response(500, "{\"message\":\"Error checking credentials\"}");
+        }
+        stmt.bind(1, username);
 
-        int rc = sqlite3_step(stmt);
+        int rc = stmt.step();
         crow::json::wvalue response;
         if (rc == SQLITE_ROW) {
-            std::string storedPassword = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-            std::string permission = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+            std::string storedPassword = stmt.text(0);
+            std::string permission = stmt.text(1);
             if (storedPassword == password) {
                 response["message"] = "Login successful";
                 response["permission"] = permission;
-                sqlite3_finalize(stmt);
-                sqlite3_close(db);
                 return crow::response(200, response);
             } else {
-                sqlite3_finalize(stmt);
-                sqlite3_close(db);
                 return crow::response(401, "{\"message\":\"Incorrect password\"}");
             }
         } else {
-            sqlite3_finalize(stmt);
-            sqlite3_close(db);
             return crow::response(401, "{\"message\":\"Invalid credentials\"}");
         }
     });
 
+    // Reservations share the desktop client's conflict rules through the engine
+    // and its rows through testdb.db, which needs a writer of its own
+    GroupCommitWriter reservationWriter(kReservationDatabasePath);
+    ReservationService reservations(kReservationDatabasePath, reservationWriter);
+    if (!reservations.load()) {
+        std::cerr << "Could not load reservations" << std::endl;
+        return 1;
+    }
+
+    // Body: {"table": "Table3", "time": <epoch seconds>, "username": "..."}
+    CROW_ROUTE(app, "/reservations").methods("POST"_method)([&reservations](const crow::request& req) {
+        auto json = crow::json::load(req.body);
+        if (!json || !json.has("table") || !json.has("time") || !json.has("username")) {
+            return message(400, "table, time and username are required");
+        }
+        // Reading a value as the wrong type throws, which Crow turns into a 500
+        if (json["table"].t() != crow::json::type::String || json["username"].t() != crow::json::type::String
+            || json["time"].t() != crow::json::type::Number
+            || json["time"].nt() == crow::json::num_type::Floating_point) {
+            return message(400, "table and username must be strings and time whole epoch seconds");
+        }
+
+        EpochSeconds slot = 0;
+        auto result = reservations.reserve(json["table"].s(), json["time"].i(), json["username"].s(), &slot);
+        if (result == ReservationService::Result::Conflict) {
+            crow::json::wvalue body;
+            body["message"] = "This time slot is already reserved";
+            body["table"] = std::string(json["table"].s());
+            body["slot"] = slot;
+            return crow::response(409, body);
+        }
+        return resultResponse(result, 201, "Reservation created");
+    });
+
+    // Query: table, time
+    CROW_ROUTE(app, "/reservations").methods("DELETE"_method)([&reservations](const crow::request& req) {
+        std::string table = stringParam(req, "table");
+        long long time = intParam(req, "time", LLONG_MIN);
+        if (table.empty() || time == LLONG_MIN) {
+            return message(400, "table and time are required");
+        }
+
+        return resultResponse(reservations.cancel(table, time), 200, "Reservation cancelled");
+    });
+
+    // Query: from, to (epoch seconds, [from, to)), username, table, limit
+    CROW_ROUTE(app, "/reservations").methods("GET"_method)([&reservations](const crow::request& req) {
+        long long from = intParam(req, "from", LLONG_MIN);
+        long long to = intParam(req, "to", LLONG_MAX);
+        long long limit = intParam(req, "limit", kDefaultListLimit);
+        if (limit < 1 || limit > kMaxListLimit) {
+            limit = kMaxListLimit;
+        }
+
+        std::vector<crow::json::wvalue> items;
+        for (const ServiceReservation &reservation :
+             reservations.list(from, to, stringParam(req, "username"), stringParam(req, "table"), int(limit))) {
+            crow::json::wvalue item;
+            item["table"] = reservation.table;
+            item["time"] = reservation.start;
+            item["username"] = reservation.username;
+            items.push_back(std::move(item));
+        }
+
+        crow::json::wvalue body;
+        body["reservations"] = std::move(items);
+        return crow::response(200, body);
+    });
+
+    // Query: from, to (epoch seconds), party. Without `to` each table is
+    // checked for its own sitting, the time a booking there would hold it
+    CROW_ROUTE(app, "/availability").methods("GET"_method)([&reservations](const crow::request& req) {
+        long long from = intParam(req, "from", LLONG_MIN);
+        if (from == LLONG_MIN) {
+            return message(400, "from is required");
+        }
+        long long party = intParam(req, "party", 1);
+        if (party < 1 || party > kMaxParty) {
+            return message(400, "Invalid time range or party size");
+        }
+        long long to = intParam(req, "to", LLONG_MIN);
+        if (to != LLONG_MIN && to <= from) {
+            return message(400, "Invalid time range or party size");
+        }
+
+        std::vector<crow::json::wvalue> items;
+        const std::vector<EngineTable> free = to == LLONG_MIN ? reservations.available(from, int(party))
+                                                              : reservations.available(from, to, int(party));
+        for (const EngineTable &table : free) {
+            crow::json::wvalue item;
+            item["table"] = table.name;
+            item["seats"] = table.seats;
+            item["vip"] = table.isVIP;
+            items.push_back(std::move(item));
+        }
+
+        crow::json::wvalue body;
+        body["tables"] = std::move(items);
+        return crow::response(200, body);
+    });
+
     app.port(8080).multithreaded().run();
 }
@@ -0,0 +1,19 @@
+TEMPLATE = app
+TARGET = server
+
+CONFIG += console c++17
+CONFIG -= app_bundle qt
+
+SOURCES += \
+    reservationservice.cpp \
+    server.cpp \
+    serverdatabase.cpp \
+
+HEADERS += \
+    reservationservice.h \
+    serverdatabase.h \
+
+include(reservationengine.pri)
+
+LIBS += -lsqlite3
+win32: LIBS += -lws2_32 -lmswsock
@@ -0,0 +1,204 @@
+#include "serverdatabase.h"
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <memory>
+
+SqliteConnection::SqliteConnection(const std::string &path)
+{
+    if (sqlite3_open(path.c_str(), &db) != SQLITE_OK) {
+        std::cerr << "Can't open database: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_close(db);
+        db = nullptr;
+        return;
+    }
+
+    // Other worker threads hold their own connections to the same file
+    sqlite3_busy_timeout(db, 5000);
+    exec("PRAGMA journal_mode = WAL");
+    exec("PRAGMA synchronous = NORMAL");
+}
+
+SqliteConnection::~SqliteConnection()
+{
+    for (auto &entry : statements) {
+        sqlite3_finalize(entry.second);
+    }
+    sqlite3_close(db);
+}
+
+SqliteConnection &SqliteConnection::forThread(const std::string &path)
+{
+    thread_local std::unordered_map<std::string, std::unique_ptr<SqliteConnection>> connections;
+
+    std::unique_ptr<SqliteConnection> &connection = connections[path];
+    if (!connection) {
+        connection = std::make_unique<SqliteConnection>(path);
+    }
+    return *connection;
+}
+
+const char *SqliteConnection::errorMessage() const
+{
+    return db ? sqlite3_errmsg(db) : "database is not open";
+}
+
+bool SqliteConnection::exec(const char *sql)
+{
+    if (!db)
+        return false;
+
+    char *errMsg = nullptr;
+    if (sqlite3_exec(db, sql, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::cerr << "SQL error: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+    return true;
+}
+
+sqlite3_stmt *SqliteConnection::statement(const std::string &sql)
+{
+    if (!db)
+        return nullptr;
+
+    auto cached = statements.find(sql);
+    if (cached != statements.end())
+        return cached->second;
+
+    sqlite3_stmt *stmt = nullptr;
+    if (sqlite3_prepare_v3(db, sql.c_str(), -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "SQL error: " << sqlite3_errmsg(db) << std::endl;
+        return nullptr;
+    }
+    statements.emplace(sql, stmt);
+    return stmt;
+}
+
+StatementLease::StatementLease(SqliteConnection &connection, const std::string &sql)
+    : stmt(connection.statement(sql))
+{}
+
+StatementLease::~StatementLease()
+{
+    if (stmt) {
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+    }
+}
+
+void StatementLease::bind(int index, const std::string &value)
+{
+    sqlite3_bind_text(stmt, index, value.c_str(), static_cast<int>(value.size()), SQLITE_TRANSIENT);
+}
+
+void StatementLease::bind(int index, std::int64_t value)
+{
+    sqlite3_bind_int64(stmt, index, value);
+}
+
+int StatementLease::step()
+{
+    return sqlite3_step(stmt);
+}
+
+std::string StatementLease::text(int column) const
+{
+    const unsigned char *value = sqlite3_column_text(stmt, column);
+    return value ? std::string(reinterpret_cast<const char *>(value)) : std::string();
+}
+
+std::int64_t StatementLease::integer(int column) const
+{
+    return sqlite3_column_int64(stmt, column);
+}
+
+GroupCommitWriter::GroupCommitWriter(const std::string &path, std::chrono::milliseconds window,
+                                     std::size_t maxBatch)
+    : path(path)
+    , window(window)
+    , maxBatch(maxBatch)
+    , writer(&GroupCommitWriter::writerLoop, this)
+{}
+
+GroupCommitWriter::~GroupCommitWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+}
+
+std::future<bool> GroupCommitWriter::submit(Job job)
+{
+    Pending pending{std::move(job), std::promise<bool>()};
+    std::future<bool> result = pending.done.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(std::move(pending));
+    }
+    wake.notify_one();
+    return result;
+}
+
+void GroupCommitWriter::writerLoop()
+{
+    SqliteConnection db(path);
+    std::vector<Pending> batch;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (queue.empty() && stopping)
+            return;
+
+        // Give writers arriving right behind the first one a chance to join
+        wake.wait_for(lock, window, [this] { return stopping || queue.size() >= maxBatch; });
+
+        std::size_t count = std::min(queue.size(), maxBatch);
+        batch.assign(std::make_move_iterator(queue.begin()),
+                     std::make_move_iterator(queue.begin() + count));
+        queue.erase(queue.begin(), queue.begin() + count);
+
+        lock.unlock();
+        commit(db, batch);
+        batch.clear();
+        lock.lock();
+    }
+}
+
+void GroupCommitWriter::commit(SqliteConnection &db, std::vector<Pending> &batch)
+{
+    if (!db.exec("BEGIN IMMEDIATE")) {
+        for (Pending &pending : batch) {
+            pending.done.set_value(false);
+        }
+        return;
+    }
+
+    std::vector<bool> results;
+    results.reserve(batch.size());
+    for (Pending &pending : batch) {
+        // A failing job only unwinds its own savepoint
+        bool ok = db.exec("SAVEPOINT job") && pending.job(db);
+        if (ok) {
+            ok = db.exec("RELEASE job");
+        } else {
+            db.exec("ROLLBACK TO job");
+            db.exec("RELEASE job");
+        }
+        results.push_back(ok);
+    }
+
+    if (!db.exec("COMMIT")) {
+        db.exec("ROLLBACK");
+        results.assign(batch.size(), false);
+    }
+
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        batch[i].done.set_value(results[i]);
+    }
+}
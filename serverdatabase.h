@@ -0,0 +1,112 @@
+#ifndef SERVERDATABASE_H
+#define SERVERDATABASE_H
+
+#include <sqlite3.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// SQLite connection owned by one server worker thread. Crow runs handlers on
+// a fixed pool of threads, so each thread opens the database once and keeps
+// every statement it has used prepared for the next request.
+class SqliteConnection
+{
+public:
+    explicit SqliteConnection(const std::string &path);
+    ~SqliteConnection();
+    SqliteConnection(const SqliteConnection &) = delete;
+    SqliteConnection &operator=(const SqliteConnection &) = delete;
+
+    // The calling thread's connection to `path`, opened on first use
+    static SqliteConnection &forThread(const std::string &path);
+
+    bool isOpen() const { return db != nullptr; }
+    sqlite3 *handle() const { return db; }
+    const char *errorMessage() const;
+
+    // Runs SQL with no parameters and no result rows
+    bool exec(const char *sql);
+    // Prepared on first use and then kept; nullptr if it does not compile
+    sqlite3_stmt *statement(const std::string &sql);
+
+private:
+    sqlite3 *db = nullptr;
+    std::unordered_map<std::string, sqlite3_stmt *> statements;
+};
+
+// A cached statement borrowed for one request. Binding copies its values,
+// and the statement is reset and unbound when the lease ends so the next
+// request starts clean.
+class StatementLease
+{
+public:
+    StatementLease(SqliteConnection &connection, const std::string &sql);
+    ~StatementLease();
+    StatementLease(const StatementLease &) = delete;
+    StatementLease &operator=(const StatementLease &) = delete;
+
+    explicit operator bool() const { return stmt != nullptr; }
+    sqlite3_stmt *get() const { return stmt; }
+
+    void bind(int index, const std::string &value);
+    void bind(int index, std::int64_t value);
+    int step();
+    std::string text(int column) const;
+    std::int64_t integer(int column) const;
+
+private:
+    sqlite3_stmt *stmt;
+};
+
+// Group commit for writes coming from many request threads. Jobs submitted
+// within a short window are run by one writer thread inside a single
+// BEGIN/COMMIT, each under its own savepoint, so a rush of inserts costs
+// one fsync per batch. Every job still learns whether its own work
+// committed.
+class GroupCommitWriter
+{
+public:
+    // Runs on the writer thread's connection; false rolls back just this job
+    using Job = std::function<bool(SqliteConnection &)>;
+
+    explicit GroupCommitWriter(const std::string &path,
+                               std::chrono::milliseconds window = std::chrono::milliseconds(3),
+                               std::size_t maxBatch = 256);
+    ~GroupCommitWriter();
+    GroupCommitWriter(const GroupCommitWriter &) = delete;
+    GroupCommitWriter &operator=(const GroupCommitWriter &) = delete;
+
+    std::future<bool> submit(Job job);
+    // Submits and waits for the batch holding this job to commit
+    bool run(Job job) { return submit(std::move(job)).get(); }
+
+private:
+    struct Pending
+    {
+        Job job;
+        std::promise<bool> done;
+    };
+
+    void writerLoop();
+    void commit(SqliteConnection &db, std::vector<Pending> &batch);
+
+    const std::string path;
+    const std::chrono::milliseconds window;
+    const std::size_t maxBatch;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<Pending> queue;
+    bool stopping = false;
+    std::thread writer;
+};
+
+#endif // SERVERDATABASE_H
@@ -0,0 +1,114 @@
+#include "slotgrid.h"
+
+#include <bitset>
+
+void SlotGrid::resize(int tableCount)
+{
+    tables = tableCount;
+    for (auto &entry : days) {
+        Day &day = entry.second;
+        day.byTable.resize(tables, 0);
+        for (std::vector<Word> &slot : day.bySlot) {
+            slot.resize(wordsPerSlot(), 0);
+        }
+    }
+}
+
+SlotGrid::Day &SlotGrid::dayFor(int day)
+{
+    auto it = days.find(day);
+    if (it != days.end())
+        return it->second;
+
+    Day &created = days[day];
+    created.byTable.assign(tables, 0);
+    for (std::vector<Word> &slot : created.bySlot) {
+        slot.assign(wordsPerSlot(), 0);
+    }
+    return created;
+}
+
+void SlotGrid::setBusy(int day, TableId id, int slot, bool busy)
+{
+    if (id < 0 || id >= tables || slot < 0 || slot >= kSlotsPerDay)
+        return;
+
+    // Don't allocate a day just to clear a bit in it
+    if (!busy && days.find(day) == days.end())
+        return;
+
+    Day &grid = dayFor(day);
+    const Word slotBit = Word(1) << slot;
+    const Word tableBit = Word(1) << (id % kWordBits);
+    Word &tableWord = grid.bySlot[slot][id / kWordBits];
+
+    if (busy) {
+        grid.byTable[id] |= slotBit;
+        tableWord |= tableBit;
+    } else {
+        grid.byTable[id] &= ~slotBit;
+        tableWord &= ~tableBit;
+    }
+}
+
+void SlotGrid::clear()
+{
+    days.clear();
+}
+
+bool SlotGrid::isBusy(int day, TableId id, int slot) const
+{
+    if (slot < 0 || slot >= kSlotsPerDay)
+        return false;
+    return (tableDay(day, id) >> slot) & 1;
+}
+
+SlotGrid::Word SlotGrid::tableDay(int day, TableId id) const
+{
+    auto it = days.find(day);
+    if (it == days.end() || id < 0 || id >= tables)
+        return 0;
+    return it->second.byTable[id];
+}
+
+const SlotGrid::Word *SlotGrid::tableWords(int day) const
+{
+    auto it = days.find(day);
+    if (it == days.end() || it->second.byTable.empty())
+        return nullptr;
+    return it->second.byTable.data();
+}
+
+int SlotGrid::busyCount(int day, int slot) const
+{
+    int count = 0;
+    for (Word word : busyTables(day, slot)) {
+        count += static_cast<int>(std::bitset<kWordBits>(word).count());
+    }
+    return count;
+}
+
+const std::vector<SlotGrid::Word> &SlotGrid::busyTables(int day, int slot) const
+{
+    static const std::vector<Word> none;
+
+    auto it = days.find(day);
+    if (it == days.end() || slot < 0 || slot >= kSlotsPerDay)
+        return none;
+    return it->second.bySlot[slot];
+}
+
+int SlotGrid::slotForSecondOfDay(int secondOfDay)
+{
+    int offset = secondOfDay - kOpeningHour * 3600;
+    if (offset < 0)
+        return -1;
+
+    int slot = offset / static_cast<int>(kSlotSeconds);
+    return slot < kSlotsPerDay ? slot : -1;
+}
+
+int SlotGrid::secondOfDayForSlot(int slot)
+{
+    return kOpeningHour * 3600 + slot * static_cast<int>(kSlotSeconds);
+}
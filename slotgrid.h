@@ -0,0 +1,61 @@
+#ifndef SLOTGRID_H
+#define SLOTGRID_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "reservationtypes.h"
+
+// Occupancy bitmaps for the bookable day grid (11:00 to 22:30 in 30 minute
+// slots, the same slots Home::populateTimeSlots offers).
+//
+// Every day keeps two views of the same bits:
+//  - byTable: one word per table, bit k set when the table is busy at slot k
+//  - bySlot:  one bitset over all tables per slot, 64 tables per word
+// The second view turns "which tables are busy at slot k" into a scan of
+// tableCount / 64 words.
+class SlotGrid
+{
+public:
+    using Word = std::uint64_t;
+
+    static constexpr int kWordBits = 64;
+    static constexpr int kOpeningHour = 11;
+    static constexpr EpochSeconds kSlotSeconds = 30 * 60;
+    static constexpr int kSlotsPerDay = 24;  // 11:00 .. 22:30
+    static_assert(kSlotsPerDay <= kWordBits, "a table's day must fit in one word");
+
+    void resize(int tableCount);
+    int tableCount() const { return tables; }
+    int wordsPerSlot() const { return (tables + kWordBits - 1) / kWordBits; }
+
+    void setBusy(int day, TableId id, int slot, bool busy);
+    void clear();
+
+    bool isBusy(int day, TableId id, int slot) const;
+    Word tableDay(int day, TableId id) const;  // bit k = busy at slot k
+    const Word *tableWords(int day) const;    // tableDay for every table, nullptr if none booked
+    int busyCount(int day, int slot) const;
+
+    // Tables busy at `slot`, as a bitset over table ids. Empty when nothing
+    // has been booked that day.
+    const std::vector<Word> &busyTables(int day, int slot) const;
+
+    static int slotForSecondOfDay(int secondOfDay);  // -1 outside opening hours
+    static int secondOfDayForSlot(int slot);
+
+private:
+    struct Day
+    {
+        std::vector<Word> byTable;
+        std::vector<Word> bySlot[kSlotsPerDay];
+    };
+
+    Day &dayFor(int day);
+
+    int tables = 0;
+    std::unordered_map<int, Day> days;
+};
+
+#endif // SLOTGRID_H
@@ -0,0 +1,60 @@
+#include "statementcache.h"
+
+#include <QDebug>
+#include <QHash>
+#include <QMutex>
+#include <QSqlError>
+
+#include <memory>
+
+namespace {
+
+struct CachedStatement
+{
+    explicit CachedStatement(const QSqlDatabase &db)
+        : query(db)
+    {
+        query.setForwardOnly(true);
+    }
+
+    QSqlQuery query;
+    bool prepared = false;
+};
+
+using ConnectionStatements = QHash<QString, std::shared_ptr<CachedStatement>>;
+
+// Connections live on different threads, so the map itself is guarded;
+// each statement is only ever touched by its connection's thread
+QMutex cacheMutex;
+QHash<QString, ConnectionStatements> cache;
+
+} // namespace
+
+QSqlQuery &StatementCache::statement(const QString &sql, const QString &connectionName)
+{
+    std::shared_ptr<CachedStatement> entry;
+    {
+        QMutexLocker locker(&cacheMutex);
+        std::shared_ptr<CachedStatement> &slot = cache[connectionName][sql];
+        if (!slot) {
+            slot = std::make_shared<CachedStatement>(QSqlDatabase::database(connectionName));
+        }
+        entry = slot;
+    }
+
+    if (entry->prepared) {
+        entry->query.finish();
+    } else {
+        entry->prepared = entry->query.prepare(sql);
+        if (!entry->prepared) {
+            qDebug() << "Failed to prepare statement:" << entry->query.lastError().text() << sql;
+        }
+    }
+    return entry->query;
+}
+
+void StatementCache::clear(const QString &connectionName)
+{
+    QMutexLocker locker(&cacheMutex);
+    cache.remove(connectionName);
+}
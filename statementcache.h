@@ -0,0 +1,25 @@
+#ifndef STATEMENTCACHE_H
+#define STATEMENTCACHE_H
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+
+// Prepared statements kept alive per connection, keyed by their SQL text.
+// Call sites ask for the same SQL every time and only rebind values, so
+// SQLite compiles each statement once per connection instead of once per
+// call. A returned query must only be used on the connection's thread and
+// only until the next statement() call for the same SQL.
+class StatementCache
+{
+public:
+    // Prepares on first use (or after a failed prepare) and releases any
+    // result set left from the previous use. Check lastError() on failure.
+    static QSqlQuery &statement(const QString &sql,
+                                const QString &connectionName = QLatin1String(QSqlDatabase::defaultConnection));
+
+    // Drops every statement of a connection; call before removeDatabase()
+    static void clear(const QString &connectionName);
+};
+
+#endif // STATEMENTCACHE_H
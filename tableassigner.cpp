@@ -0,0 +1,159 @@
+#include "tableassigner.h"
+
+#include <algorithm>
+#include <iterator>
+#include <set>
+#include <tuple>
+
+TableAssigner::TableAssigner(const ReservationEngine &engine)
+    : engine(engine)
+{}
+
+void TableAssigner::setJoinable(TableId a, TableId b)
+{
+    // A stale or mistyped id would index past the engine's tables in assign()
+    if (a == b || !engine.isValid(a) || !engine.isValid(b))
+        return;
+
+    const std::size_t needed = static_cast<std::size_t>(std::max(a, b)) + 1;
+    if (joins.size() < needed)
+        joins.resize(needed);
+
+    if (std::find(joins[a].begin(), joins[a].end(), b) == joins[a].end()) {
+        joins[a].push_back(b);
+        joins[b].push_back(a);
+    }
+}
+
+void TableAssigner::clearJoins()
+{
+    joins.clear();
+}
+
+const std::vector<TableId> &TableAssigner::joinableWith(TableId id) const
+{
+    static const std::vector<TableId> none;
+    return id >= 0 && static_cast<std::size_t>(id) < joins.size() ? joins[id] : none;
+}
+
+void TableAssigner::setInService(TableId id, bool inService)
+{
+    if (id < 0)
+        return;
+    if (outOfService.size() <= static_cast<std::size_t>(id))
+        outOfService.resize(static_cast<std::size_t>(id) + 1, 0);
+    outOfService[id] = inService ? 0 : 1;
+}
+
+bool TableAssigner::isInService(TableId id) const
+{
+    return id < 0 || static_cast<std::size_t>(id) >= outOfService.size() || !outOfService[id];
+}
+
+EpochSeconds TableAssigner::strandedAround(TableId id, EpochSeconds start) const
+{
+    const SittingPolicy &policy = engine.sittingPolicy();
+    const EpochSeconds shortest = std::min({policy.upToTwo, policy.upToFour, policy.larger});
+    const EpochSeconds end = start + engine.sittingFor(id);
+
+    // Idle time is bounded by the neighbouring bookings and by the day grid
+    const int day = engine.dayIndex(start);
+    EpochSeconds before = engine.slotStart(day, 0);
+    EpochSeconds after = engine.slotStart(day, SlotGrid::kSlotsPerDay);
+
+    const ReservationEngine::SlotIndex &index = engine.reservations(id);
+    auto next = index.lower_bound(start);
+    if (next != index.end())
+        after = std::min(after, next->first);
+    if (next != index.begin())
+        before = std::max(before, std::prev(next)->second);
+
+    EpochSeconds stranded = 0;
+    const EpochSeconds gaps[] = {start - before, after - end};
+    for (EpochSeconds gap : gaps) {
+        if (gap > 0 && gap < shortest)
+            stranded += gap;
+    }
+    return stranded;
+}
+
+TableAssigner::Assignment TableAssigner::score(const std::vector<TableId> &tables, int party,
+                                               EpochSeconds start) const
+{
+    Assignment assignment;
+    assignment.tables = tables;
+    for (TableId id : tables) {
+        assignment.seats += engine.tables().seats(id);
+        assignment.strandedSeconds += strandedAround(id, start);
+        if (engine.tables().isVIP(id))
+            ++assignment.vipTables;
+    }
+    assignment.wastedSeats = assignment.seats - party;
+    return assignment;
+}
+
+bool TableAssigner::better(const Assignment &a, const Assignment &b)
+{
+    if (!b.isValid())
+        return a.isValid();
+    return std::make_tuple(a.wastedSeats, a.tables.size(), a.strandedSeconds, a.vipTables, a.tables)
+           < std::make_tuple(b.wastedSeats, b.tables.size(), b.strandedSeconds, b.vipTables, b.tables);
+}
+
+TableAssigner::Assignment TableAssigner::assign(int party, EpochSeconds start) const
+{
+    Assignment best;
+    if (party < 1)
+        return best;
+
+    // Best fit over single tables first
+    for (TableId id : engine.tablesWithSeats(party)) {
+        if (!isInService(id) || !engine.isFree(id, start))
+            continue;
+        Assignment candidate = score({id}, party, start);
+        if (better(candidate, best))
+            best = candidate;
+    }
+    if (best.isValid() && best.wastedSeats == 0)
+        return best;  // No join can beat an exact single table
+
+    // Then grow groups of joinable free tables. A group stops growing once
+    // it seats the party, since another table would only add empty seats.
+    std::vector<char> free(engine.tableCount(), 0);
+    for (TableId id : engine.freeTablesAt(start)) {
+        free[id] = isInService(id);
+    }
+
+    std::set<std::vector<TableId>> seen;
+    std::vector<std::vector<TableId>> frontier;
+    for (TableId id = 0; id < engine.tableCount(); ++id) {
+        if (free[id] && !joinableWith(id).empty())
+            frontier.push_back({id});
+    }
+
+    for (int size = 2; size <= kMaxJoin && !frontier.empty(); ++size) {
+        std::vector<std::vector<TableId>> grown;
+        for (const std::vector<TableId> &group : frontier) {
+            for (TableId member : group) {
+                for (TableId neighbour : joinableWith(member)) {
+                    if (!engine.isValid(neighbour) || !free[neighbour] || std::find(group.begin(), group.end(), neighbour) != group.end())
+                        continue;
+
+                    std::vector<TableId> joined = group;
+                    joined.insert(std::upper_bound(joined.begin(), joined.end(), neighbour), neighbour);
+                    if (!seen.insert(joined).second)
+                        continue;
+
+                    Assignment candidate = score(joined, party, start);
+                    if (candidate.wastedSeats < 0) {
+                        grown.push_back(std::move(joined));
+                    } else if (better(candidate, best)) {
+                        best = candidate;
+                    }
+                }
+            }
+        }
+        frontier.swap(grown);
+    }
+    return best;
+}
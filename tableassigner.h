@@ -0,0 +1,58 @@
+#ifndef TABLEASSIGNER_H
+#define TABLEASSIGNER_H
+
+#include <vector>
+
+#include "reservationengine.h"
+
+// Picks where to seat a party. Single tables and groups of up to kMaxJoin
+// joinable neighbours that are free for their whole sitting are ranked by,
+// in order:
+//  1. empty seats left over,
+//  2. number of tables used,
+//  3. stranded time: idle gaps left before and after the booking that are
+//     too short to sell another sitting,
+//  4. VIP tables used, so they stay free for the parties that need them.
+// Candidates come from the catalog's seat filter and each table's interval
+// tree, so a search costs O(tables x log n) plus a small join enumeration.
+class TableAssigner
+{
+public:
+    static constexpr int kMaxJoin = 3;
+
+    struct Assignment
+    {
+        std::vector<TableId> tables;  // Empty when nothing fits
+        int seats = 0;
+        int wastedSeats = 0;
+        EpochSeconds strandedSeconds = 0;
+        int vipTables = 0;
+
+        bool isValid() const { return !tables.empty(); }
+    };
+
+    explicit TableAssigner(const ReservationEngine &engine);
+
+    // Tables that can be pushed together for one party; ids the engine does
+    // not know are ignored
+    void setJoinable(TableId a, TableId b);
+    void clearJoins();
+    const std::vector<TableId> &joinableWith(TableId id) const;
+
+    // Tables taken out of service are never offered
+    void setInService(TableId id, bool inService);
+    bool isInService(TableId id) const;
+
+    Assignment assign(int party, EpochSeconds start) const;
+
+private:
+    EpochSeconds strandedAround(TableId id, EpochSeconds start) const;
+    Assignment score(const std::vector<TableId> &tables, int party, EpochSeconds start) const;
+    static bool better(const Assignment &a, const Assignment &b);
+
+    const ReservationEngine &engine;
+    std::vector<std::vector<TableId>> joins;  // Indexed by TableId
+    std::vector<char> outOfService;           // Indexed by TableId
+};
+
+#endif // TABLEASSIGNER_H
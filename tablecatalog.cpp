@@ -0,0 +1,21 @@
+#include "tablecatalog.h"
+
+TableId TableCatalog::add(const std::string &name, int seats, bool isVIP, double minSpend)
+{
+    TableId id = size();
+    names.push_back(name);
+    seatCounts.push_back(seats);
+    vipFlags.push_back(isVIP ? 1 : 0);
+    minSpends.push_back(minSpend);
+    return id;
+}
+
+void TableCatalog::update(TableId id, int seats, bool isVIP, double minSpend)
+{
+    if (!contains(id))
+        return;
+
+    seatCounts[id] = seats;
+    vipFlags[id] = isVIP ? 1 : 0;
+    minSpends[id] = minSpend;
+}
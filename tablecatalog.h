@@ -0,0 +1,38 @@
+#ifndef TABLECATALOG_H
+#define TABLECATALOG_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "reservationtypes.h"
+
+// Table attributes stored as parallel arrays indexed by TableId, so scans
+// over one attribute (seats, VIP flag, ...) walk contiguous memory and can be
+// fed straight into AvailabilityKernel.
+class TableCatalog
+{
+public:
+    TableId add(const std::string &name, int seats, bool isVIP, double minSpend);
+    void update(TableId id, int seats, bool isVIP, double minSpend);
+
+    int size() const { return static_cast<int>(names.size()); }
+    bool contains(TableId id) const { return id >= 0 && id < size(); }
+
+    const std::string &name(TableId id) const { return names[id]; }
+    int seats(TableId id) const { return seatCounts[id]; }
+    bool isVIP(TableId id) const { return vipFlags[id] != 0; }
+    double minSpend(TableId id) const { return minSpends[id]; }
+
+    const std::int32_t *seatData() const { return seatCounts.data(); }
+    const std::uint8_t *vipData() const { return vipFlags.data(); }
+    const double *minSpendData() const { return minSpends.data(); }
+
+private:
+    std::vector<std::string> names;
+    std::vector<std::int32_t> seatCounts;
+    std::vector<std::uint8_t> vipFlags;
+    std::vector<double> minSpends;
+};
+
+#endif // TABLECATALOG_H
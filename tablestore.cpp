@@ -0,0 +1,28 @@
+#include "tablestore.h"
+
+void TableStore::set(TableId id, const QString &name, const TableInfo &info)
+{
+    if (id < 0)
+        return;
+
+    if (id >= infos.size()) {
+        infos.resize(id + 1);
+        names.resize(id + 1);
+    }
+
+    // Re-registering under a new name drops the old interned entry
+    if (!names[id].isEmpty() && names[id] != name) {
+        ids.remove(names[id]);
+    }
+
+    infos[id] = info;
+    names[id] = name;
+    ids.insert(name, id);
+}
+
+void TableStore::clear()
+{
+    infos.clear();
+    names.clear();
+    ids.clear();
+}
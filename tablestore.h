@@ -0,0 +1,56 @@
+#ifndef TABLESTORE_H
+#define TABLESTORE_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include "reservationtypes.h"
+
+class TableInfo
+{
+public:
+    int seats;
+    bool isReserved;
+    QDateTime reservationTime;
+    QString customerName;
+    bool isVIP;
+    QString specialNotes;
+    double minSpend;
+    bool inService;
+
+    TableInfo(int s = 4)
+        : seats(s)
+        , isReserved(false)
+        , isVIP(s >= 8)
+        , minSpend(0.0)
+        , inService(true)
+    {}
+};
+
+// Flat, TableId-indexed storage for the floor plan. Table names such as
+// "Table13" are interned once when a table is registered; after that every
+// lookup is a vector index and names are only used for display, widget
+// object names and persistence.
+class TableStore
+{
+public:
+    void set(TableId id, const QString &name, const TableInfo &info);
+    void clear();
+
+    int size() const { return infos.size(); }
+    bool contains(TableId id) const { return id >= 0 && id < infos.size(); }
+    TableId id(const QString &name) const { return ids.value(name, -1); }
+
+    const QString &name(TableId id) const { return names[id]; }
+    TableInfo &operator[](TableId id) { return infos[id]; }
+    const TableInfo &operator[](TableId id) const { return infos[id]; }
+
+private:
+    QVector<TableInfo> infos;
+    QVector<QString> names;
+    QHash<QString, TableId> ids;
+};
+
+#endif // TABLESTORE_H
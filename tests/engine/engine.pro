@@ -0,0 +1,10 @@
+TEMPLATE = app
+TARGET = tst_engine
+
+CONFIG += console c++17 testcase
+CONFIG -= app_bundle qt
+
+SOURCES += \
+    tst_engine.cpp \
+
+include(../../reservationengine.pri)
@@ -0,0 +1,301 @@
+// Unit tests for the GUI-free reservation engine. Plain C++ like the engine
+// itself, so they build wherever the server does. Exits non-zero on failure.
+
+#include <climits>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "availabilitykernel.h"
+#include "reseatingsolver.h"
+#include "tableassigner.h"
+#include "reservationengine.h"
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const char *expression, int line)
+{
+    if (!condition) {
+        std::printf("FAIL line %d: %s\n", line, expression);
+        ++failures;
+    }
+}
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+constexpr int kDay = 20000;  // Grid days are UTC here, no offset is set
+constexpr EpochSeconds kMinute = 60;
+
+void reserveRefusesOverlap()
+{
+    ReservationEngine engine;
+    TableId two = engine.addTable("Table1", 2, false);  // 60 minute sitting
+    const int slot = 4;
+    const EpochSeconds t = engine.slotStart(kDay, slot);
+
+    CHECK(engine.reserve(two, t));
+    CHECK(!engine.reserve(two, t + 30 * kMinute));
+    CHECK(!engine.reserve(two, t - 30 * kMinute));
+    CHECK(engine.reserve(two, t + 60 * kMinute));  // Back to back is fine
+    CHECK(engine.isReservedAt(two, t));
+    CHECK(!engine.isFree(two, t + 59 * kMinute, t + 61 * kMinute));
+
+    CHECK(engine.slotGrid().isBusy(kDay, two, slot));
+    CHECK(engine.slotGrid().isBusy(kDay, two, slot + 3));
+    CHECK(!engine.slotGrid().isBusy(kDay, two, slot + 4));
+    CHECK(engine.findFreeTables(kDay, slot, slot + 1, 1).empty());
+
+    CHECK(engine.cancel(two, t));
+    CHECK(!engine.cancel(two, t));
+    CHECK(!engine.slotGrid().isBusy(kDay, two, slot));
+    CHECK(engine.slotGrid().isBusy(kDay, two, slot + 2));
+    CHECK(engine.countStarts(two, t, t + 120 * kMinute) == 1);
+}
+
+void restoreTrimsOverlap()
+{
+    ReservationEngine engine;
+    TableId four = engine.addTable("Table1", 4, false);  // 90 minute sitting
+    const int slot = 2;
+    const EpochSeconds t = engine.slotStart(kDay, slot);
+
+    // A later start cuts the earlier booking short
+    CHECK(engine.restore(four, t));
+    CHECK(engine.restore(four, t + 60 * kMinute));
+    const ReservationEngine::SlotIndex &index = engine.reservations(four);
+    CHECK(index.size() == 2);
+    CHECK(index.at(t) == t + 60 * kMinute);
+    CHECK(index.at(t + 60 * kMinute) == t + 150 * kMinute);
+
+    // One in between is trimmed on both sides
+    CHECK(engine.restore(four, t + 30 * kMinute));
+    CHECK(index.at(t) == t + 30 * kMinute);
+    CHECK(index.at(t + 30 * kMinute) == t + 60 * kMinute);
+
+    // The same start twice is refused and changes nothing
+    CHECK(!engine.restore(four, t));
+    CHECK(index.size() == 3);
+
+    // The grid follows the trimmed lengths
+    CHECK(engine.cancel(four, t + 30 * kMinute));
+    CHECK(engine.slotGrid().isBusy(kDay, four, slot));
+    CHECK(!engine.slotGrid().isBusy(kDay, four, slot + 1));
+    CHECK(engine.slotGrid().isBusy(kDay, four, slot + 2));
+    CHECK(engine.isFree(four, t + 30 * kMinute, t + 60 * kMinute));
+}
+
+void kernelMatchesScalar()
+{
+    std::mt19937 random(20240501);
+    const AvailabilityKernel::Path paths[] = {AvailabilityKernel::Path::SSE41, AvailabilityKernel::Path::AVX2};
+    std::printf("Kernel path on this CPU: %s\n", AvailabilityKernel::pathName(AvailabilityKernel::activePath()));
+
+    // Counts around the 4 and 8 lane widths exercise the scalar tails
+    for (int tableCount : {0, 1, 3, 4, 7, 8, 9, 31, 64, 65, 100}) {
+        std::vector<std::int32_t> seats(tableCount);
+        std::vector<std::uint64_t> words(tableCount);
+        for (int i = 0; i < tableCount; ++i) {
+            seats[i] = int(random() % 12) + 1;
+            words[i] = std::uint64_t(random()) << 32 | random();
+            words[i] &= std::uint64_t(random()) << 32 | random();  // Mostly free
+        }
+
+        for (int round = 0; round < 200; ++round) {
+            int first = int(random() % SlotGrid::kSlotsPerDay);
+            int last = first + 1 + int(random() % (SlotGrid::kSlotsPerDay - first));
+            SlotGrid::Word mask = ReservationEngine::slotMask(first, last);
+            int minSeats = int(random() % 14) - 1;
+            int maxSeats = round % 5 == 0 ? INT_MAX : minSeats + int(random() % 8);
+            const std::uint64_t *dayWords = round % 7 == 0 ? nullptr : words.data();
+
+            std::vector<TableId> expected;
+            int expectedCount = AvailabilityKernel::findFreeTablesScalar(seats.data(), dayWords, 0, tableCount,
+                                                                         mask, minSeats, maxSeats, expected);
+            for (AvailabilityKernel::Path path : paths) {
+                std::vector<TableId> found;
+                int count = AvailabilityKernel::findFreeTables(path, seats.data(), dayWords, tableCount,
+                                                               mask, minSeats, maxSeats, found);
+                CHECK(count == expectedCount);
+                CHECK(found == expected);
+            }
+        }
+    }
+}
+
+void assignerIgnoresUnknownJoins()
+{
+    ReservationEngine engine;
+    TableId first = engine.addTable("Table1", 2, false);
+    TableId second = engine.addTable("Table2", 2, false);
+
+    TableAssigner assigner(engine);
+    assigner.setJoinable(first, 7);
+    assigner.setJoinable(-1, second);
+    CHECK(assigner.joinableWith(first).empty());
+    CHECK(assigner.joinableWith(7).empty());
+    CHECK(!assigner.assign(4, engine.slotStart(kDay, 0)).isValid());
+
+    assigner.setJoinable(first, second);
+    const TableAssigner::Assignment joined = assigner.assign(4, engine.slotStart(kDay, 0));
+    CHECK(joined.tables == std::vector<TableId>({first, second}));
+}
+
+void solverMovesFewestBookings()
+{
+    // Table1's booking has to go. Placing the addition on its best fit
+    // first leaves only plans that also move a Table4 booking; moving the
+    // Table1 booking to the 4-top instead moves just that one.
+    ReservationEngine engine;
+    TableId closed = engine.addTable("Table1", 2, false);
+    TableId two = engine.addTable("Table2", 2, false);
+    TableId four = engine.addTable("Table3", 4, false);
+    TableId other = engine.addTable("Table4", 2, false);
+    CHECK(engine.reserve(closed, engine.slotStart(kDay, 0)));
+    CHECK(engine.reserve(four, engine.slotStart(kDay, 3)));
+    CHECK(engine.reserve(other, engine.slotStart(kDay, 0)));
+    CHECK(engine.reserve(other, engine.slotStart(kDay, 3)));
+
+    ReseatingSolver::Request request;
+    request.day = kDay;
+    request.outOfService.push_back(closed);
+    request.additions.push_back({1, engine.slotStart(kDay, 1)});
+
+    for (int threads : {1, 4}) {
+        ReseatingSolver solver(engine);
+        solver.setThreadCount(threads);
+        const ReseatingSolver::Plan plan = solver.solve(request);
+        CHECK(plan.feasible);
+        CHECK(plan.optimal);
+        CHECK(plan.movedBookings == 1);
+        CHECK(plan.moves.size() == 2);
+        if (plan.moves.size() == 2) {
+            CHECK(plan.moves[0].from == closed && plan.moves[0].to == four);
+            CHECK(plan.moves[0].end == plan.moves[0].start + engine.sittingFor(four));
+            CHECK(plan.moves[1].from == -1 && plan.moves[1].to == two);
+        }
+    }
+}
+
+void solverLeavesStartedBookings()
+{
+    ReservationEngine engine;
+    TableId closed = engine.addTable("Table1", 2, false);
+    TableId open = engine.addTable("Table2", 2, false);
+    const EpochSeconds started = engine.slotStart(kDay, 0);
+    const EpochSeconds later = engine.slotStart(kDay, 4);
+    CHECK(engine.reserve(closed, started));
+    CHECK(engine.reserve(closed, later));
+    CHECK(engine.reserve(open, started));
+
+    ReseatingSolver::Request request;
+    request.day = kDay;
+    request.notBefore = engine.slotStart(kDay, 1);
+    request.outOfService.push_back(closed);
+
+    ReseatingSolver solver(engine);
+    const ReseatingSolver::Plan plan = solver.solve(request);
+    CHECK(plan.feasible);
+    CHECK(plan.movedBookings == 1);
+    CHECK(plan.moves.size() == 1);
+    if (plan.moves.size() == 1)
+        CHECK(plan.moves[0].from == closed && plan.moves[0].to == open && plan.moves[0].start == later);
+}
+
+// Fewest moves over every assignment of the day's bookings to tables
+int exhaustiveMoves(const ReservationEngine &engine, const std::vector<char> &inService,
+                    const std::vector<ReseatingSolver::Booking> &bookings, const std::vector<TableId> &original)
+{
+    const int count = static_cast<int>(bookings.size());
+    std::vector<TableId> assignment(count);
+    int best = INT_MAX;
+    std::function<void(int, int)> search = [&](int i, int moved) {
+        if (moved >= best)
+            return;
+        if (i == count) {
+            best = moved;
+            return;
+        }
+        for (TableId id = 0; id < engine.tableCount(); ++id) {
+            if (!inService[id] || engine.tables().seats(id) < bookings[i].party)
+                continue;
+            const EpochSeconds start = bookings[i].start;
+            const EpochSeconds end = start + engine.sittingFor(id);
+            bool clash = false;
+            for (int j = 0; j < i && !clash; ++j) {
+                clash = assignment[j] == id && bookings[j].start < end
+                        && start < bookings[j].start + engine.sittingFor(id);
+            }
+            if (clash)
+                continue;
+            assignment[i] = id;
+            search(i + 1, moved + (original[i] >= 0 && original[i] != id));
+        }
+    };
+    search(0, 0);
+    return best;
+}
+
+void solverMatchesExhaustiveSearch()
+{
+    std::mt19937 random(7);
+    for (int round = 0; round < 3000; ++round) {
+        ReservationEngine engine;
+        const int tableCount = 2 + int(random() % 3);
+        for (int i = 0; i < tableCount; ++i) {
+            engine.addTable("Table" + std::to_string(i + 1), 2 + 2 * int(random() % 3), false);
+        }
+
+        std::vector<ReseatingSolver::Booking> bookings;
+        std::vector<TableId> original;
+        for (int i = 2 + int(random() % 5); i > 0; --i) {
+            TableId id = TableId(random() % tableCount);
+            EpochSeconds start = engine.slotStart(kDay, int(random() % 6));
+            if (engine.reserve(id, start)) {
+                bookings.push_back({engine.tables().seats(id), start});
+                original.push_back(id);
+            }
+        }
+
+        ReseatingSolver::Request request;
+        request.day = kDay;
+        request.outOfService.push_back(TableId(random() % tableCount));
+        for (int i = int(random() % 3); i > 0; --i) {
+            request.additions.push_back({1 + int(random() % 6), engine.slotStart(kDay, int(random() % 6))});
+            bookings.push_back(request.additions.back());
+            original.push_back(-1);
+        }
+        std::vector<char> inService(tableCount, 1);
+        inService[request.outOfService.front()] = 0;
+
+        ReseatingSolver solver(engine);
+        solver.setThreadCount(1);
+        const ReseatingSolver::Plan plan = solver.solve(request);
+        const int fewest = exhaustiveMoves(engine, inService, bookings, original);
+        CHECK(plan.feasible == (fewest != INT_MAX));
+        if (plan.feasible && plan.optimal)
+            CHECK(plan.movedBookings == fewest);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    reserveRefusesOverlap();
+    restoreTrimsOverlap();
+    kernelMatchesScalar();
+    assignerIgnoresUnknownJoins();
+    solverMovesFewestBookings();
+    solverLeavesStartedBookings();
+    solverMatchesExhaustiveSearch();
+
+    if (failures)
+        std::printf("%d check(s) failed\n", failures);
+    else
+        std::printf("All checks passed\n");
+    return failures ? 1 : 0;
+}
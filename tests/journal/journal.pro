@@ -0,0 +1,17 @@
+TEMPLATE = app
+TARGET = tst_journal
+
+QT = core testlib
+CONFIG += console c++17 testcase
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    tst_journal.cpp \
+    ../../reservationjournal.cpp \
+    ../../reservationsnapshot.cpp \
+
+HEADERS += \
+    ../../reservationjournal.h \
+    ../../reservationsnapshot.h \
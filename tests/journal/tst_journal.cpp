@@ -0,0 +1,177 @@
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include "reservationjournal.h"
+#include "reservationsnapshot.h"
+
+class JournalTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void replaysInOrder();
+    void dropsTornTail();
+    void startsOverWithoutHeader();
+    void asksAgainUntilCompacted();
+    void snapshotRoundTrip();
+    void snapshotRejectsTruncation();
+
+private:
+    static QVector<ReservationJournal::Record> replayAll(ReservationJournal &journal);
+
+    QTemporaryDir dir;
+};
+
+QVector<ReservationJournal::Record> JournalTest::replayAll(ReservationJournal &journal)
+{
+    QVector<ReservationJournal::Record> records;
+    journal.replay([&](const ReservationJournal::Record &record) { records.append(record); });
+    return records;
+}
+
+void JournalTest::replaysInOrder()
+{
+    const QString path = dir.filePath("order.journal");
+    {
+        ReservationJournal journal(path);
+        QVERIFY(journal.append({ReservationJournal::Reserve, 3, 1000, 7}));
+        QVERIFY(journal.append({ReservationJournal::Cancel, 3, 1000, 7}));
+        QVERIFY(journal.append({ReservationJournal::OutOfService, 5, 2000, 8}));
+    }
+
+    ReservationJournal journal(path);
+    const QVector<ReservationJournal::Record> records = replayAll(journal);
+    QCOMPARE(records.size(), 3);
+    QCOMPARE(records[0].op, ReservationJournal::Reserve);
+    QCOMPARE(records[1].op, ReservationJournal::Cancel);
+    QCOMPARE(records[2].op, ReservationJournal::OutOfService);
+    QCOMPARE(records[2].table, 5);
+    QCOMPARE(records[2].time, EpochSeconds(2000));
+    QCOMPARE(records[2].userId, 8);
+    QCOMPARE(journal.size(), 3);
+}
+
+void JournalTest::dropsTornTail()
+{
+    const QString path = dir.filePath("torn.journal");
+    {
+        ReservationJournal journal(path);
+        for (int i = 0; i < 4; ++i) {
+            QVERIFY(journal.append({ReservationJournal::Reserve, i, 1000 + i, 1}));
+        }
+    }
+
+    // A crash part way through the last record
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(file.size() - ReservationJournal::kRecordSize / 2));
+    file.close();
+
+    ReservationJournal journal(path);
+    QVector<ReservationJournal::Record> records = replayAll(journal);
+    QCOMPARE(records.size(), 3);
+    QCOMPARE(records.last().table, 2);
+
+    // The next append overwrites the torn bytes
+    QVERIFY(journal.append({ReservationJournal::Cancel, 9, 5000, 1}));
+    journal.sync();
+    records = replayAll(journal);
+    QCOMPARE(records.size(), 4);
+    QCOMPARE(records.last().op, ReservationJournal::Cancel);
+    QCOMPARE(records.last().table, 9);
+}
+
+void JournalTest::startsOverWithoutHeader()
+{
+    const QString path = dir.filePath("garbage.journal");
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(QByteArray(3 * ReservationJournal::kRecordSize, 'x'));
+    file.close();
+
+    ReservationJournal journal(path);
+    QCOMPARE(replayAll(journal).size(), 0);
+    QVERIFY(journal.append({ReservationJournal::Reserve, 1, 1000, 1}));
+    QCOMPARE(replayAll(journal).size(), 1);
+}
+
+void JournalTest::asksAgainUntilCompacted()
+{
+    const QString path = dir.filePath("long.journal");
+    {
+        // Nobody compacts this one
+        ReservationJournal journal(path);
+        QSignalSpy due(&journal, &ReservationJournal::compactionDue);
+        for (int i = 0; i < ReservationJournal::kCompactAfter + 10; ++i) {
+            QVERIFY(journal.append({ReservationJournal::Reserve, 1, 1000 + i, 1}));
+        }
+        QCOMPARE(due.count(), 1);
+    }
+
+    // Still too long when opened again
+    ReservationJournal journal(path);
+    QSignalSpy due(&journal, &ReservationJournal::compactionDue);
+    QCOMPARE(replayAll(journal).size(), ReservationJournal::kCompactAfter + 10);
+    QCOMPARE(due.count(), 1);
+
+    // A failed compaction is retried, but not on every append
+    for (int i = 1; i < ReservationJournal::kCompactRetry; ++i) {
+        QVERIFY(journal.append({ReservationJournal::Cancel, 1, 1000, 1}));
+    }
+    QCOMPARE(due.count(), 1);
+    QVERIFY(journal.append({ReservationJournal::Cancel, 1, 1000, 1}));
+    QCOMPARE(due.count(), 2);
+
+    journal.reset();
+    QCOMPARE(journal.size(), 0);
+    QVERIFY(journal.append({ReservationJournal::Reserve, 1, 1000, 1}));
+    QCOMPARE(due.count(), 2);
+}
+
+void JournalTest::snapshotRoundTrip()
+{
+    const QString path = dir.filePath("round.snapshot");
+    QVector<ReservationSnapshot::TableSource> tables;
+    tables.append({"Table1", 2, false, true, true, 1000, "Ana", {1000, 5000}});
+    tables.append({"Table2", 8, true, false, false, ReservationSnapshot::kNoTime, QString(), {}});
+    QVERIFY(ReservationSnapshot::write(path, tables));
+
+    ReservationSnapshot snapshot;
+    QVERIFY(snapshot.open(path));
+    QCOMPARE(snapshot.tableCount(), 2);
+
+    const ReservationSnapshot::Table first = snapshot.table(0);
+    QCOMPARE(first.name, QString("Table1"));
+    QCOMPARE(first.seats, 2);
+    QVERIFY(first.isReserved);
+    QVERIFY(first.inService);
+    QCOMPARE(first.reservationTime, EpochSeconds(1000));
+    QCOMPARE(first.customerName, QString("Ana"));
+    QCOMPARE(first.timeCount, 2);
+    QCOMPARE(EpochSeconds(first.times[1]), EpochSeconds(5000));
+
+    const ReservationSnapshot::Table second = snapshot.table(1);
+    QVERIFY(second.isVIP);
+    QVERIFY(!second.inService);
+    QCOMPARE(second.timeCount, 0);
+}
+
+void JournalTest::snapshotRejectsTruncation()
+{
+    const QString path = dir.filePath("short.snapshot");
+    QVector<ReservationSnapshot::TableSource> tables;
+    tables.append({"Table1", 4, false, false, true, ReservationSnapshot::kNoTime, QString(), {1000, 2000, 3000}});
+    QVERIFY(ReservationSnapshot::write(path, tables));
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(file.size() - 8));
+    file.close();
+
+    ReservationSnapshot snapshot;
+    QVERIFY(!snapshot.open(path));
+}
+
+QTEST_GUILESS_MAIN(JournalTest)
+#include "tst_journal.moc"
@@ -0,0 +1,8 @@
+# Unit tests, run with `make check`. The engine tests are plain C++ like the
+# engine itself; the journal tests need QtCore and QtTest.
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    engine \
+    journal \
@@ -2,6 +2,7 @@
 #include "ui_usersignup.h"
 #include <QSqlQuery>
 #include <QSqlError>
+#include "statementcache.h"
 #include <QCryptographicHash>
 #include <QMessageBox>
 
@@ -38,10 +39,11 @@ void usersignup::on_pushButton_clicked()
     QString hashedPassword = hashPassword(password);
 
     // Check if username already exists
-    QSqlQuery query;
-    query.prepare("SELECT username FROM users WHERE username = :username");
+    QSqlQuery &query = StatementCache::statement("SELECT username FROM users WHERE username = :username");
     query.bindValue(":username", username);
-    if (query.exec() && query.next()) {
+    bool taken = query.exec() && query.next();
+    query.finish();
+    if (taken) {
         QMessageBox::warning(this, "Signup Error", "Username already exists. Please choose a different username.");
         return;
     }